@@ -1,9 +1,18 @@
 #include "config.h"
+#include <string_view>
+#include <utility>
 
 namespace config {
 
 void Config::set(const std::string& key, const std::string& value) {
-    log_.info("Config set: " + key + " = " + value);
+    // One exact-size allocation; chained operator+ would make a temporary
+    // per step and usually regrow each one.
+    static constexpr std::string_view prefix = "Config set: ";
+    static constexpr std::string_view equals = " = ";
+    std::string msg;
+    msg.reserve(prefix.size() + key.size() + equals.size() + value.size());
+    msg.append(prefix).append(key).append(equals).append(value);
+    log_.info(std::move(msg));
     values_[key] = value;
 }
 
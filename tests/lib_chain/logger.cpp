@@ -12,8 +12,8 @@ const char* Logger::level_name(Level l) {
     return "UNKNOWN";
 }
 
-void Logger::log(Level level, const std::string& msg) {
-    entries_.push_back({level, msg});
+void Logger::log(Level level, std::string msg) {
+    entries_.push_back({level, std::move(msg)});
 }
 
 }  // namespace logger
@@ -3,6 +3,7 @@
 #define LOGGER_H
 
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace logger {
@@ -16,11 +17,13 @@ struct LogEntry {
 
 class Logger {
 public:
-    void log(Level level, const std::string& msg);
-    void debug(const std::string& msg) { log(Level::DEBUG, msg); }
-    void info(const std::string& msg)  { log(Level::INFO, msg); }
-    void warn(const std::string& msg)  { log(Level::WARN, msg); }
-    void error(const std::string& msg) { log(Level::ERROR, msg); }
+    // Messages are taken by value so callers that build one can move it
+    // straight into the entry instead of copying it.
+    void log(Level level, std::string msg);
+    void debug(std::string msg) { log(Level::DEBUG, std::move(msg)); }
+    void info(std::string msg)  { log(Level::INFO, std::move(msg)); }
+    void warn(std::string msg)  { log(Level::WARN, std::move(msg)); }
+    void error(std::string msg) { log(Level::ERROR, std::move(msg)); }
 
     const std::vector<LogEntry>& entries() const { return entries_; }
     std::size_t count() const { return entries_.size(); }
@@ -0,0 +1,468 @@
+// Header-only library: asynchronous events delivered on consumer threads
+#ifndef ASYNC_EVENT_HPP
+#define ASYNC_EVENT_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "concurrent_event.hpp"
+#include "delegate.hpp"
+#include "event.hpp"
+
+namespace events {
+
+// Room for the queued call: the target event plus the emitted arguments
+// (a std::string and a couple of scalars, or a Payload<T> handle).
+constexpr std::size_t kAsyncMessageCapacity = 8 * sizeof(void*);
+
+// What emit() does when a consumer's queue is full.
+enum class Overflow {
+    DropOldest,  // discard the oldest queued event to make room
+    Block,       // wait (yielding) until the consumer frees a slot
+    Fail,        // leave the queue alone; emit() returns false
+};
+
+struct AsyncOptions {
+    std::size_t capacity = 1024;  // rounded up to a power of two
+    Overflow overflow = Overflow::Block;
+    std::size_t batch = 64;       // events claimed per drain step
+    bool own_thread = true;       // false: the owner calls drain() itself
+};
+
+// ── Latency histogram ───────────────────────────────────────────────────────
+// Log-linear buckets: exact below 8 ns, then eight buckets per power of two,
+// so a percentile is within 12.5% of the true value. One writer (the
+// consumer thread), any number of readers.
+class LatencyHistogram {
+public:
+    static constexpr std::size_t kBuckets = 8 + 61 * 8;
+
+    void record(std::uint64_t ns) {
+        auto& bucket = counts_[bucket_of(ns)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (ns > max_.load(std::memory_order_relaxed)) max_.store(ns, std::memory_order_relaxed);
+    }
+
+    // Upper bound of the bucket holding the q-th quantile (0 < q <= 1), or 0
+    // when nothing has been recorded.
+    std::uint64_t percentile(double q) const {
+        std::uint64_t total = 0;
+        for (const auto& c : counts_) total += c.load(std::memory_order_relaxed);
+        if (total == 0) return 0;
+        // The q-th quantile is the ceil(q * total)-th smallest sample.
+        auto rank = static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(total)));
+        rank = std::clamp<std::uint64_t>(rank, 1, total);
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            seen += counts_[i].load(std::memory_order_relaxed);
+            if (seen >= rank) return std::min(upper_bound(i), max());
+        }
+        return max();
+    }
+
+    std::uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+
+private:
+    static std::size_t bucket_of(std::uint64_t ns) {
+        if (ns < 8) return static_cast<std::size_t>(ns);
+        unsigned msb = 63u - static_cast<unsigned>(__builtin_clzll(ns));
+        return (msb - 2) * 8 + static_cast<std::size_t>((ns >> (msb - 3)) & 7);
+    }
+
+    static std::uint64_t upper_bound(std::size_t bucket) {
+        if (bucket < 8) return bucket;
+        unsigned shift = static_cast<unsigned>(bucket / 8 - 1);
+        return ((8 + bucket % 8 + 1) << shift) - 1;
+    }
+
+    std::atomic<std::uint64_t> counts_[kBuckets] = {};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+// ── MPSC ring ───────────────────────────────────────────────────────────────
+// Bounded queue of queued calls, one per consumer. Each cell carries a
+// sequence number that says whether it is free for the producer at a given
+// position or ready for the consumer (Vyukov's bounded queue), so producers
+// contend only on the tail index and never wait for each other. The head is
+// claimed with a CAS rather than a plain store because a DropOldest producer
+// may pop from it too.
+class AsyncRing {
+public:
+    using Message = Delegate<void(), kAsyncMessageCapacity>;
+
+    explicit AsyncRing(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) size *= 2;
+        mask_ = size - 1;
+        cells_.reset(new Cell[size]);
+        for (std::size_t i = 0; i < size; ++i) cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+    // Events pushed so far (the tail position).
+    std::size_t pushed() const { return tail_.load(std::memory_order_relaxed); }
+
+    std::size_t depth() const {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    // Moves func into the ring only on success, so a failed push can be
+    // retried with the same callable.
+    template <typename Func>
+    bool try_push(Func& func, std::int64_t enqueued_ns) {
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->message = std::move(func);
+        cell->enqueued_ns = enqueued_ns;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Claims up to `max` consecutive ready cells with one CAS and returns
+    // how many; the caller then take()s each of [*first, *first + n).
+    std::size_t claim(std::size_t max, std::size_t* first) {
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            std::size_t n = 0;
+            while (n < max && cells_[(pos + n) & mask_].sequence.load(std::memory_order_acquire) == pos + n + 1) ++n;
+            if (n == 0) return 0;
+            if (head_.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+                *first = pos;
+                return n;
+            }
+        }
+    }
+
+    // Moves a claimed cell's call out and frees the cell for producers.
+    Message take(std::size_t pos, std::int64_t* enqueued_ns) {
+        Cell& cell = cells_[pos & mask_];
+        Message message = std::move(cell.message);
+        *enqueued_ns = cell.enqueued_ns;
+        cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return message;
+    }
+
+    bool drop_oldest() {
+        std::size_t pos;
+        if (claim(1, &pos) == 0) return false;
+        std::int64_t unused;
+        take(pos, &unused);
+        return true;
+    }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<std::size_t> sequence{0};
+        std::int64_t enqueued_ns = 0;
+        Message message;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    std::size_t mask_ = 0;
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    alignas(64) std::atomic<std::size_t> head_{0};
+};
+
+struct AsyncStats {
+    std::size_t capacity = 0;
+    std::size_t depth = 0;      // queued now
+    std::size_t max_depth = 0;  // deepest seen by the consumer
+    std::uint64_t enqueued = 0;
+    std::uint64_t delivered = 0;
+    std::uint64_t dropped = 0;   // evicted by DropOldest
+    std::uint64_t rejected = 0;  // refused by Fail
+    std::uint64_t batches = 0;
+    // Emit to handler start, in nanoseconds.
+    std::uint64_t p50_ns = 0;
+    std::uint64_t p99_ns = 0;
+    std::uint64_t p999_ns = 0;
+    std::uint64_t max_ns = 0;
+};
+
+// ── AsyncConsumer ───────────────────────────────────────────────────────────
+// A thread (or, with own_thread = false, whoever calls drain()) that runs
+// the handlers subscribed to it, in emit order per producer. Producers only
+// push onto its ring: a slow handler delays this consumer and nothing else.
+//
+// The thread drains in batches; once the ring is empty it yields a few
+// times and then sleeps until a producer pushes again. Waking it is the one
+// system call a producer can make, once per idle period. On destruction the
+// thread delivers everything still queued and exits; a consumer without a
+// thread destroys what is left undelivered.
+//
+// Queued calls point at their event: flush() or destroy a consumer before
+// the events routed to it, and do not emit to an event whose consumer is
+// gone.
+class AsyncConsumer {
+public:
+    explicit AsyncConsumer(AsyncOptions options = {}) : options_(options), ring_(options.capacity) {
+        if (options_.batch == 0) throw std::invalid_argument("AsyncOptions::batch must be at least 1");
+        if (options_.own_thread) thread_ = std::thread([this] { run(); });
+    }
+
+    ~AsyncConsumer() {
+        if (thread_.joinable()) {
+            stopping_.store(true);
+            wake();
+            thread_.join();
+        }
+    }
+
+    AsyncConsumer(const AsyncConsumer&) = delete;
+    AsyncConsumer& operator=(const AsyncConsumer&) = delete;
+
+    // Queues a call for this consumer, applying the overflow policy.
+    // Returns false only under Overflow::Fail with a full ring.
+    template <typename Func>
+    bool post(Func&& func, std::int64_t enqueued_ns) {
+        while (!ring_.try_push(func, enqueued_ns)) {
+            if (options_.overflow == Overflow::Fail) {
+                rejected_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (options_.overflow == Overflow::DropOldest) {
+                if (ring_.drop_oldest()) dropped_.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping_.load(std::memory_order_relaxed)) wake();
+        return true;
+    }
+
+    // Runs up to `max` queued calls on the calling thread and returns how
+    // many ran. Only for consumers built with own_thread = false.
+    std::size_t drain(std::size_t max) {
+        std::size_t done = 0;
+        while (done < max) {
+            std::size_t first;
+            std::size_t n = ring_.claim(std::min(options_.batch, max - done), &first);
+            if (n == 0) break;
+            std::size_t depth = ring_.pushed() - first;
+            if (depth > max_depth_.load(std::memory_order_relaxed)) max_depth_.store(depth, std::memory_order_relaxed);
+            for (std::size_t i = 0; i < n; ++i) {
+                std::int64_t enqueued_ns;
+                AsyncRing::Message message = ring_.take(first + i, &enqueued_ns);
+                latency_.record(static_cast<std::uint64_t>(std::max<std::int64_t>(now_ns() - enqueued_ns, 0)));
+                message();
+            }
+            done += n;
+            delivered_.store(delivered_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+            batches_.store(batches_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            completed_.store(first + n, std::memory_order_release);
+        }
+        return done;
+    }
+
+    // Waits until every call queued before flush() was delivered or
+    // dropped. Must not be called from one of this consumer's handlers.
+    void flush() {
+        std::size_t target = ring_.pushed();
+        while (completed_.load(std::memory_order_acquire) < target) {
+            if (!options_.own_thread) {
+                if (drain(options_.batch) == 0) note_idle();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    AsyncStats stats() const {
+        AsyncStats s;
+        s.capacity = ring_.capacity();
+        s.depth = ring_.depth();
+        s.max_depth = max_depth_.load(std::memory_order_relaxed);
+        s.enqueued = ring_.pushed();
+        s.delivered = delivered_.load(std::memory_order_relaxed);
+        s.dropped = dropped_.load(std::memory_order_relaxed);
+        s.rejected = rejected_.load(std::memory_order_relaxed);
+        s.batches = batches_.load(std::memory_order_relaxed);
+        s.p50_ns = latency_.percentile(0.50);
+        s.p99_ns = latency_.percentile(0.99);
+        s.p999_ns = latency_.percentile(0.999);
+        s.max_ns = latency_.max();
+        return s;
+    }
+
+    const AsyncOptions& options() const { return options_; }
+
+    static std::int64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+private:
+    void run() {
+        for (;;) {
+            if (drain(options_.batch) > 0) continue;
+            note_idle();
+            bool idle = true;
+            for (int spin = 0; spin < 16 && idle; ++spin) {
+                std::this_thread::yield();
+                idle = ring_.depth() == 0;
+            }
+            if (!idle) continue;
+            if (stopping_.load()) {
+                if (drain(options_.batch) == 0) return;
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            sleeping_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            wake_cv_.wait(lock, [this] { return ring_.depth() != 0 || stopping_.load(); });
+            sleeping_.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    // Everything claimed so far has run; positions popped by DropOldest
+    // producers count as done too.
+    void note_idle() {
+        std::size_t head = ring_.pushed() - ring_.depth();
+        if (head > completed_.load(std::memory_order_relaxed)) completed_.store(head, std::memory_order_release);
+    }
+
+    void wake() {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        wake_cv_.notify_one();
+    }
+
+    AsyncOptions options_;
+    AsyncRing ring_;
+    LatencyHistogram latency_;
+    // Written by producers, on the overflow paths only.
+    alignas(64) std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<std::uint64_t> rejected_{0};
+    std::atomic<bool> sleeping_{false};
+    // Written by the consumer.
+    alignas(64) std::atomic<std::uint64_t> delivered_{0};
+    std::atomic<std::uint64_t> batches_{0};
+    std::atomic<std::size_t> max_depth_{0};
+    std::atomic<std::size_t> completed_{0};
+    std::atomic<bool> stopping_{false};
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_cv_;
+    std::thread thread_;
+};
+
+// ── AsyncEvent ──────────────────────────────────────────────────────────────
+// An event whose handlers run on the consumer they were subscribed with.
+// emit() reads the clock, copies the arguments into one queued call per
+// consumer subscribed here and returns. It takes no lock, and the queued
+// call lives inline in the consumer's ring; the only allocations are
+// whatever copying the arguments does (a long std::string, say). On the
+// consumer the call emits a ConcurrentEvent holding that
+// consumer's handlers, so subscribing and unsubscribing are safe from any
+// thread while producers and consumers run.
+//
+// Arguments are copied, so they must be values: pass large messages as a
+// Payload<T>. A consumer stays routed once it has had a handler here; at
+// most kMaxConsumers consumers per event.
+template <typename... Args>
+class AsyncEvent {
+    static_assert(!std::disjunction_v<std::is_reference<Args>...>,
+                  "AsyncEvent arguments are copied to another thread: use values or Payload<T>");
+
+public:
+    using HandlerId = std::uint64_t;
+    static constexpr std::size_t kMaxConsumers = 16;
+
+    AsyncEvent() = default;
+    AsyncEvent(const AsyncEvent&) = delete;
+    AsyncEvent& operator=(const AsyncEvent&) = delete;
+
+    template <typename Func>
+    HandlerId subscribe(AsyncConsumer& consumer, Func&& handler) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        std::size_t count = route_count_.load(std::memory_order_relaxed);
+        std::size_t r = 0;
+        while (r < count && routes_[r].consumer != &consumer) ++r;
+        if (r == count) {
+            if (count == kMaxConsumers) throw std::length_error("too many consumers for one AsyncEvent");
+            routes_[r].consumer = &consumer;
+            routes_[r].target = std::make_unique<ConcurrentEvent<Args...>>();
+            route_count_.store(count + 1, std::memory_order_release);
+        }
+        return static_cast<HandlerId>(r) << 56 | routes_[r].target->subscribe(std::forward<Func>(handler));
+    }
+
+    // Unknown and already-removed IDs are ignored. A call already queued
+    // may still reach the handler; flush() the consumer to rule that out.
+    void unsubscribe(HandlerId id) {
+        std::size_t r = static_cast<std::size_t>(id >> 56);
+        if (r >= route_count_.load(std::memory_order_acquire)) return;
+        routes_[r].target->unsubscribe(id & ((HandlerId{1} << 56) - 1));
+    }
+
+    // Returns false if a consumer with Overflow::Fail had no room.
+    bool emit(const Args&... args) const {
+        const std::size_t count = route_count_.load(std::memory_order_acquire);
+        if (count == 0) return true;
+        const std::int64_t now = AsyncConsumer::now_ns();
+        bool accepted = true;
+        for (std::size_t r = 0; r < count; ++r) {
+            const ConcurrentEvent<Args...>* target = routes_[r].target.get();
+            accepted &= routes_[r].consumer->post(
+                [target, payload = std::tuple<Args...>(args...)] {
+                    std::apply([target](const Args&... a) { target->emit(a...); }, payload);
+                },
+                now);
+        }
+        return accepted;
+    }
+
+    std::size_t subscriber_count() const {
+        std::size_t total = 0;
+        const std::size_t count = route_count_.load(std::memory_order_acquire);
+        for (std::size_t r = 0; r < count; ++r) total += routes_[r].target->subscriber_count();
+        return total;
+    }
+
+private:
+    // Written once under write_mutex_, before route_count_ publishes it.
+    struct Route {
+        AsyncConsumer* consumer = nullptr;
+        std::unique_ptr<ConcurrentEvent<Args...>> target;
+    };
+
+    Route routes_[kMaxConsumers];
+    std::atomic<std::size_t> route_count_{0};
+    std::mutex write_mutex_;
+};
+
+// Named async events: on(key, consumer, handler) subscribes on a consumer
+// and emit(channel, args...) returns false when a Fail consumer was full.
+// Resolve channels before producers start; emitting through a Channel is
+// then safe from any number of threads.
+using AsyncEventBus = BasicEventBus<AsyncEvent>;
+
+}  // namespace events
+
+#endif  // ASYNC_EVENT_HPP
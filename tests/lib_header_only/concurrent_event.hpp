@@ -0,0 +1,250 @@
+// Header-only library: a thread-safe event with lock-free emit
+#ifndef CONCURRENT_EVENT_HPP
+#define CONCURRENT_EVENT_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "delegate.hpp"
+
+namespace events {
+
+// ── Epoch-based reclamation ─────────────────────────────────────────────────
+// Readers announce the global epoch in a per-thread slot for the length of
+// a read; a writer tags what it unpublishes with the epoch current at that
+// point and frees it once no reader announces an epoch at or below the tag.
+// All announcement, publication and epoch operations are seq_cst, which is
+// what makes "announced a later epoch" imply "sees the new pointer".
+class EpochDomain {
+    struct ThreadReader;
+
+public:
+    static constexpr std::size_t kMaxReaders = 256;
+    static constexpr std::uint64_t kIdle = ~std::uint64_t{0};
+
+    static EpochDomain& instance() {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    // RAII read-side critical section. Nests; only the outermost one
+    // announces. The first guard on a thread claims a slot (lock-free, at
+    // most kMaxReaders probes); after that entering and leaving are a load
+    // and a store each. Throws std::length_error when more than kMaxReaders
+    // threads read at once.
+    class Guard {
+    public:
+        explicit Guard(EpochDomain& d) : reader_(d.reader()) {
+            if (reader_.depth++ == 0) reader_.slot->store(d.epoch_.load());
+        }
+        ~Guard() {
+            if (--reader_.depth == 0) reader_.slot->store(kIdle);
+        }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        ThreadReader& reader_;
+    };
+
+    // Epoch to tag an object unpublished just now; advances the epoch so
+    // later readers are distinguishable from ones that may still see it.
+    std::uint64_t retire_epoch() { return epoch_.fetch_add(1); }
+
+    // Objects tagged with an epoch below this are unreachable.
+    std::uint64_t safe_epoch() const {
+        std::uint64_t oldest = epoch_.load();
+        for (const auto& slot : slots_) {
+            std::uint64_t e = slot.epoch.load();
+            if (e < oldest) oldest = e;
+        }
+        return oldest;
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> epoch{kIdle};
+        std::atomic<bool> claimed{false};
+    };
+
+    // Releases the slot when its thread exits.
+    struct ThreadReader {
+        std::atomic<std::uint64_t>* slot = nullptr;
+        std::atomic<bool>* claimed = nullptr;
+        int depth = 0;
+        ~ThreadReader() {
+            if (claimed) claimed->store(false, std::memory_order_release);
+        }
+    };
+
+    ThreadReader& reader() {
+        thread_local ThreadReader r;
+        if (r.slot == nullptr) {
+            for (auto& s : slots_) {
+                bool expected = false;
+                if (!s.claimed.load(std::memory_order_relaxed) &&
+                    s.claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                    r.slot = &s.epoch;
+                    r.claimed = &s.claimed;
+                    break;
+                }
+            }
+            if (r.slot == nullptr) throw std::length_error("too many threads reading concurrent events");
+        }
+        return r;
+    }
+
+    std::atomic<std::uint64_t> epoch_{1};
+    Slot slots_[kMaxReaders];
+};
+
+// ── ConcurrentEvent ─────────────────────────────────────────────────────────
+// Event for many emitting threads. emit() takes no lock: it enters an epoch
+// guard, loads the current handler snapshot through an atomic pointer and
+// calls the handlers in it, so emitters never wait for each other or for
+// writers. subscribe()/unsubscribe() serialize on a mutex, build a new
+// immutable snapshot, publish it and retire the old one (and any removed
+// handler) for reclamation once every emit that could see it has finished.
+//
+// Handlers run concurrently on the emitting threads and must be
+// thread-safe. An emit already in progress may still call a handler after
+// unsubscribe() returns; synchronize() waits until none can. Handlers may
+// subscribe and unsubscribe from inside emit. The event must not be
+// destroyed while another thread is emitting it.
+template <typename HandlerType, typename... Args>
+class BasicConcurrentEvent {
+public:
+    using Handler = HandlerType;
+    using HandlerId = std::uint64_t;
+
+    BasicConcurrentEvent() : snapshot_(new Snapshot) {}
+
+    ~BasicConcurrentEvent() {
+        Snapshot* s = snapshot_.load();
+        for (Node* n : s->nodes) delete n;
+        delete s;
+        for (auto& r : retired_) {
+            delete r.snapshot;
+            delete r.node;
+        }
+    }
+
+    BasicConcurrentEvent(const BasicConcurrentEvent&) = delete;
+    BasicConcurrentEvent& operator=(const BasicConcurrentEvent&) = delete;
+
+    template <typename Func>
+    HandlerId subscribe(Func&& handler) {
+        auto* node = new Node{0, Handler(std::forward<Func>(handler))};
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        node->id = next_id_++;
+        const Snapshot* old = snapshot_.load();
+        auto* next = new Snapshot;
+        next->nodes.reserve(old->nodes.size() + 1);
+        next->nodes = old->nodes;
+        next->nodes.push_back(node);
+        publish(next, nullptr);
+        return node->id;
+    }
+
+    // Unknown and already-removed IDs are ignored.
+    void unsubscribe(HandlerId id) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        const Snapshot* old = snapshot_.load();
+        Node* removed = nullptr;
+        auto* next = new Snapshot;
+        next->nodes.reserve(old->nodes.size());
+        for (Node* n : old->nodes) {
+            if (n->id == id) {
+                removed = n;
+            } else {
+                next->nodes.push_back(n);
+            }
+        }
+        if (removed == nullptr) {
+            delete next;
+            return;
+        }
+        publish(next, removed);
+    }
+
+    void emit(const Args&... args) const {
+        EpochDomain::Guard guard(domain_);
+        const Snapshot* s = snapshot_.load();
+        for (const Node* n : s->nodes) n->handler(args...);
+    }
+
+    std::size_t subscriber_count() const {
+        EpochDomain::Guard guard(domain_);
+        return snapshot_.load()->nodes.size();
+    }
+
+    // Blocks until every emit that started before the call has returned,
+    // then frees what they could have been using. Must not be called from
+    // a handler.
+    void synchronize() {
+        std::uint64_t target = domain_.retire_epoch();
+        while (domain_.safe_epoch() <= target) std::this_thread::yield();
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        reclaim();
+    }
+
+    // Objects waiting for reclamation (for tests and monitoring).
+    std::size_t retired_count() const {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        return retired_.size();
+    }
+
+private:
+    struct Node {
+        HandlerId id;
+        Handler handler;
+    };
+    struct Snapshot {
+        std::vector<Node*> nodes;
+    };
+    struct Retired {
+        std::uint64_t epoch;
+        Snapshot* snapshot;
+        Node* node;
+    };
+
+    // Called with write_mutex_ held.
+    void publish(Snapshot* next, Node* removed) {
+        Snapshot* old = snapshot_.exchange(next);
+        retired_.push_back({domain_.retire_epoch(), old, removed});
+        reclaim();
+    }
+
+    void reclaim() {
+        if (retired_.empty()) return;
+        const std::uint64_t safe = domain_.safe_epoch();
+        std::size_t kept = 0;
+        for (auto& r : retired_) {
+            if (r.epoch < safe) {
+                delete r.snapshot;
+                delete r.node;
+            } else {
+                retired_[kept++] = r;
+            }
+        }
+        retired_.resize(kept);
+    }
+
+    std::atomic<Snapshot*> snapshot_;
+    EpochDomain& domain_ = EpochDomain::instance();
+    mutable std::mutex write_mutex_;
+    std::vector<Retired> retired_;
+    HandlerId next_id_ = 0;
+};
+
+template <typename... Args>
+using ConcurrentEvent = BasicConcurrentEvent<Delegate<void(const Args&...)>, Args...>;
+
+}  // namespace events
+
+#endif  // CONCURRENT_EVENT_HPP
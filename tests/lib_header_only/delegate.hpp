@@ -0,0 +1,124 @@
+// Header-only library: a fixed-capacity callable wrapper that never allocates
+#ifndef DELEGATE_HPP
+#define DELEGATE_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace events {
+
+// Room for a lambda capturing four pointers (or a pointer and a couple of
+// ints and a double).
+constexpr std::size_t kDelegateCapacity = 4 * sizeof(void*);
+
+template <typename Signature, std::size_t Capacity = kDelegateCapacity>
+class Delegate;
+
+// Like std::function, but the callable always lives in an inline buffer of
+// Capacity bytes: constructing one never allocates, and a callable that
+// does not fit is a compile error rather than a hidden heap allocation.
+// Move-only, so it also holds move-only callables (lambdas owning a
+// unique_ptr). Calling an empty Delegate throws std::bad_function_call.
+//
+// Trivially copyable callables (plain function pointers, lambdas capturing
+// pointers and scalars) are moved with a memcpy and need no destructor.
+template <typename R, typename... Args, std::size_t Capacity>
+class Delegate<R(Args...), Capacity> {
+public:
+    template <typename F>
+    static constexpr bool fits = sizeof(F) <= Capacity && alignof(F) <= alignof(std::max_align_t) &&
+                                 std::is_nothrow_move_constructible_v<F>;
+
+    Delegate() noexcept = default;
+    Delegate(std::nullptr_t) noexcept {}
+
+    template <typename F, typename D = std::decay_t<F>,
+              typename = std::enable_if_t<!std::is_same_v<D, Delegate> && std::is_invocable_r_v<R, D&, Args...>>>
+    Delegate(F&& f) {
+        static_assert(sizeof(D) <= Capacity, "callable too large for this Delegate: capture less or raise Capacity");
+        static_assert(alignof(D) <= alignof(std::max_align_t), "over-aligned callable");
+        static_assert(std::is_nothrow_move_constructible_v<D>, "Delegate callables must be nothrow movable");
+        if constexpr (std::is_pointer_v<D> || std::is_member_pointer_v<D>) {
+            if (f == nullptr) return;
+        }
+        ::new (static_cast<void*>(storage_)) D(std::forward<F>(f));
+        invoke_ = &call<D>;
+        if constexpr (!std::is_trivially_copyable_v<D> || !std::is_trivially_destructible_v<D>) {
+            manage_ = &manage<D>;
+        }
+    }
+
+    Delegate(Delegate&& other) noexcept { take(other); }
+
+    Delegate& operator=(Delegate&& other) noexcept {
+        if (this != &other) {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+
+    Delegate& operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    Delegate(const Delegate&) = delete;
+    Delegate& operator=(const Delegate&) = delete;
+
+    ~Delegate() { reset(); }
+
+    explicit operator bool() const noexcept { return invoke_ != &empty; }
+
+    R operator()(Args... args) const { return invoke_(storage_, std::forward<Args>(args)...); }
+
+private:
+    enum class Op { Move, Destroy };
+    using Invoker = R (*)(void*, Args&&...);
+    using Manager = void (*)(Op, void*, void*);
+
+    template <typename D>
+    static R call(void* p, Args&&... args) {
+        return static_cast<R>(std::invoke(*static_cast<D*>(p), std::forward<Args>(args)...));
+    }
+
+    [[noreturn]] static R empty(void*, Args&&...) { throw std::bad_function_call(); }
+
+    // Move: relocate src into dst and destroy src. Destroy: destroy src.
+    template <typename D>
+    static void manage(Op op, void* dst, void* src) {
+        D* from = static_cast<D*>(src);
+        if (op == Op::Move) ::new (dst) D(std::move(*from));
+        from->~D();
+    }
+
+    void take(Delegate& other) noexcept {
+        if (other.manage_ != nullptr) {
+            other.manage_(Op::Move, storage_, other.storage_);
+        } else if (other.invoke_ != &empty) {
+            std::memcpy(storage_, other.storage_, Capacity);
+        }
+        invoke_ = other.invoke_;
+        manage_ = other.manage_;
+        other.invoke_ = &empty;
+        other.manage_ = nullptr;
+    }
+
+    void reset() noexcept {
+        if (manage_ != nullptr) manage_(Op::Destroy, nullptr, storage_);
+        invoke_ = &empty;
+        manage_ = nullptr;
+    }
+
+    alignas(std::max_align_t) mutable unsigned char storage_[Capacity] = {};
+    Invoker invoke_ = &empty;
+    Manager manage_ = nullptr;
+};
+
+}  // namespace events
+
+#endif  // DELEGATE_HPP
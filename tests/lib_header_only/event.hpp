@@ -2,79 +2,362 @@
 #ifndef EVENT_HPP
 #define EVENT_HPP
 
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <vector>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <algorithm>
 #include <iostream>
+#include "delegate.hpp"
 
 namespace events {
 
-template <typename... Args>
-class Event {
+// HandlerType is any callable wrapper constructible from the handlers
+// passed to subscribe(): Delegate<void(const Args&...)> (the default, see
+// Event below) or std::function<void(const Args&...)> for captures too
+// large to store inline.
+//
+// emit() converts its arguments to Args once and hands every handler the
+// same const references, so nothing is copied per handler unless the
+// handler itself takes a parameter by value. Reference arguments pass
+// through unchanged: Event<Frame&> handlers may modify the frame.
+//
+// Handlers sit in a dense vector in subscription order and are reached
+// through a slot map: a HandlerId packs a slot index with the slot's
+// generation, which changes whenever the slot is released, so a stale ID
+// never unsubscribes a later handler. subscribe() and unsubscribe() are
+// O(1) (amortized): unsubscribing leaves a tombstone that emit skips, and
+// the vector is compacted, order preserved, once half of it is dead.
+//
+// Handlers may subscribe and unsubscribe (themselves or others) and clear
+// the event while it is being emitted. Removals take effect immediately;
+// handlers added during an emit, nested emits included, are only called
+// once the outermost emit has returned. Removed handlers are destroyed
+// then too.
+//
+// Not thread-safe, emit() included: it is const so that const owners can
+// fire events, but it updates the mutable bookkeeping below, so two
+// threads emitting the same event concurrently race. Synchronize every
+// call on one event externally, or use ConcurrentEvent
+// (concurrent_event.hpp), whose emit() may run on any number of threads.
+template <typename HandlerType, typename... Args>
+class BasicEvent {
 public:
-    using Handler = std::function<void(Args...)>;
-    using HandlerId = std::size_t;
+    using Handler = HandlerType;
+    using HandlerId = std::uint64_t;
 
-    HandlerId subscribe(Handler handler) {
-        handlers_.push_back({next_id_, std::move(handler)});
-        return next_id_++;
+    template <typename Func>
+    HandlerId subscribe(Func&& handler) {
+        std::uint32_t slot;
+        if (free_slots_.empty()) {
+            slot = static_cast<std::uint32_t>(slots_.size());
+            slots_.push_back({0, 0});
+        } else {
+            slot = free_slots_.back();
+            free_slots_.pop_back();
+        }
+        // Entries added during an emit wait in pending_; their index runs on
+        // from the end of handlers_, which emit never resizes.
+        slots_[slot].index = static_cast<std::uint32_t>(handlers_.size() + pending_.size());
+        auto& target = emit_depth_ > 0 ? pending_ : handlers_;
+        target.push_back({Handler(std::forward<Func>(handler)), slot, true});
+        return static_cast<HandlerId>(slots_[slot].generation) << 32 | slot;
     }
 
+    // Unknown and already-removed IDs are ignored.
     void unsubscribe(HandlerId id) {
-        handlers_.erase(
-            std::remove_if(handlers_.begin(), handlers_.end(),
-                           [id](const Entry& e) { return e.id == id; }),
-            handlers_.end());
+        auto slot = static_cast<std::uint32_t>(id);
+        if (slot >= slots_.size() || slots_[slot].generation != static_cast<std::uint32_t>(id >> 32)) return;
+        std::size_t index = slots_[slot].index;
+        Entry& entry = index < handlers_.size() ? handlers_[index] : pending_[index - handlers_.size()];
+        release(entry);
+        if (emit_depth_ == 0) settle();
     }
 
-    void emit(Args... args) const {
-        for (const auto& entry : handlers_) {
-            entry.handler(args...);
+    void emit(const Args&... args) const {
+        // Indexing, not iterators: the vector stays put during the emit, but
+        // a handler may tombstone any entry, including the current one.
+        EmitScope scope(*this);
+        const std::size_t n = handlers_.size();
+        for (std::size_t i = 0; i < n; ++i) {
+            const Entry& entry = handlers_[i];
+            if (entry.live) entry.handler(args...);
         }
     }
 
-    std::size_t subscriber_count() const { return handlers_.size(); }
+    std::size_t subscriber_count() const { return handlers_.size() + pending_.size() - dead_; }
 
-    void clear() { handlers_.clear(); }
+    void clear() {
+        for (auto& entry : handlers_) release(entry);
+        for (auto& entry : pending_) release(entry);
+        if (emit_depth_ == 0) settle();
+    }
 
 private:
     struct Entry {
-        HandlerId id;
         Handler handler;
+        std::uint32_t slot;
+        bool live;
+    };
+    struct Slot {
+        std::uint32_t index;       // into handlers_, then pending_
+        std::uint32_t generation;  // bumped on release
     };
-    std::vector<Entry> handlers_;
-    HandlerId next_id_ = 0;
+
+    struct EmitScope {
+        explicit EmitScope(const BasicEvent& e) : event(e) { ++event.emit_depth_; }
+        ~EmitScope() {
+            if (--event.emit_depth_ == 0) event.settle();
+        }
+        const BasicEvent& event;
+    };
+
+    // Outside emit the handler (and whatever it captured) is destroyed at
+    // once; during one it may be running, so it is destroyed by settle().
+    void release(Entry& entry) const {
+        if (!entry.live) return;
+        entry.live = false;
+        ++dead_;
+        if (emit_depth_ > 0) {
+            doomed_.push_back(slots_[entry.slot].index);
+        } else {
+            entry.handler = Handler();
+        }
+        ++slots_[entry.slot].generation;
+        free_slots_.push_back(entry.slot);
+    }
+
+    // Merges handlers added during an emit, destroys the ones removed
+    // during it, and compacts tombstones once they are half the vector.
+    // Only runs outside emit.
+    void settle() const {
+        for (auto& entry : pending_) handlers_.push_back(std::move(entry));
+        pending_.clear();
+        for (std::uint32_t index : doomed_) handlers_[index].handler = Handler();
+        doomed_.clear();
+        if (dead_ == 0 || dead_ * 2 < handlers_.size()) return;
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < handlers_.size(); ++i) {
+            if (!handlers_[i].live) continue;
+            if (kept != i) handlers_[kept] = std::move(handlers_[i]);
+            slots_[handlers_[kept].slot].index = static_cast<std::uint32_t>(kept);
+            ++kept;
+        }
+        handlers_.erase(handlers_.begin() + static_cast<std::ptrdiff_t>(kept), handlers_.end());
+        dead_ = 0;
+    }
+
+    // Bookkeeping is mutable so that emit() stays const while still
+    // applying what its handlers deferred.
+    mutable std::vector<Entry> handlers_;
+    mutable std::vector<Entry> pending_;
+    mutable std::vector<Slot> slots_;
+    mutable std::vector<std::uint32_t> free_slots_;
+    mutable std::vector<std::uint32_t> doomed_;  // released during emit
+    mutable std::size_t dead_ = 0;
+    mutable int emit_depth_ = 0;
+};
+
+template <typename... Args>
+using Event = BasicEvent<Delegate<void(const Args&...)>, Args...>;
+
+// Payload-by-handle: for messages too large to copy, emit an
+// Event<Payload<T>>. The message is built once, immutable, and handlers
+// that keep it share ownership: copying a Payload copies a pointer and
+// bumps a reference count.
+template <typename T>
+using Payload = std::shared_ptr<const T>;
+
+template <typename T, typename... CtorArgs>
+Payload<T> make_payload(CtorArgs&&... args) {
+    return std::make_shared<const T>(std::forward<CtorArgs>(args)...);
+}
+
+// Handlers in std::function, for captures too large for a Delegate.
+template <typename... Args>
+using FunctionEvent = BasicEvent<std::function<void(const Args&...)>, Args...>;
+
+// ── EventBus ────────────────────────────────────────────────────────────────
+// FNV-1a; constexpr so that keys spelled as literals hash at compile time.
+constexpr std::uint64_t event_name_hash(std::string_view name) {
+    std::uint64_t h = 0xcbf29ce484222325ULL;
+    for (char c : name) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+// A named event together with the arguments it carries:
+//   constexpr events::EventKey<int, std::string> kMessage{"message"};
+template <typename... Args>
+struct EventKey {
+    constexpr explicit EventKey(std::string_view n) : name(n), hash(event_name_hash(n)) {}
+    std::string_view name;
+    std::uint64_t hash;
+};
+
+template <template <typename...> class EventTemplate>
+class BasicEventBus;
+
+// An EventKey resolved by one bus: a dense index into that bus's channels.
+// Only valid with the bus that produced it.
+template <typename... Args>
+class Channel {
+public:
+    std::uint32_t index() const { return index_; }
+
+private:
+    template <template <typename...> class>
+    friend class BasicEventBus;
+    explicit Channel(std::uint32_t index) : index_(index) {}
+    std::uint32_t index_;
+};
+
+template <typename T>
+struct TypeIdentity {
+    using type = T;
 };
 
-// Convenience: named event bus
-class EventBus {
+// Named events, each an EventTemplate<Args...> (Event by default,
+// FunctionEvent for std::function handlers, AsyncEvent for AsyncEventBus in
+// async_event.hpp). There are three ways to name one, fastest last:
+//   - a string, for names only known at run time: hashed on every call;
+//     emit(name) and on(name, ...) address void() events;
+//   - an EventKey: hashed at compile time, one hash-table probe per call;
+//   - a Channel from channel(key): emit is an array index, no hashing and
+//     no allocation.
+// A name carries one argument list; using it with another throws
+// std::invalid_argument, as does a 64-bit hash collision between names.
+// The bus is as thread-safe as its events: emit() is const but, with the
+// default Event, must not run concurrently with itself.
+template <template <typename...> class EventTemplate = Event>
+class BasicEventBus {
 public:
-    template <typename Func>
-    std::size_t on(const std::string& event_name, Func&& handler) {
-        auto& ev = events_[event_name];
-        ev.push_back({next_id_, std::forward<Func>(handler)});
-        return next_id_++;
+    template <typename... Args>
+    using EventType = EventTemplate<Args...>;
+
+    // Finds or creates the event's channel.
+    template <typename... Args>
+    Channel<Args...> channel(const EventKey<Args...>& key) {
+        return Channel<Args...>(resolve<Args...>(key.name, key.hash));
     }
 
-    void emit(const std::string& event_name) {
-        auto it = events_.find(event_name);
-        if (it != events_.end()) {
-            for (const auto& entry : it->second) {
-                entry.handler();
-            }
-        }
+    // Passes its arguments after the channel to the event's subscribe():
+    // the handler, preceded by the consumer for an AsyncEventBus.
+    template <typename... Args, typename... SubscribeArgs>
+    auto on(Channel<Args...> channel, SubscribeArgs&&... subscribe_args) {
+        return event<Args...>(channel.index_).subscribe(std::forward<SubscribeArgs>(subscribe_args)...);
+    }
+
+    template <typename... Args, typename... SubscribeArgs>
+    auto on(const EventKey<Args...>& key, SubscribeArgs&&... subscribe_args) {
+        return on(channel(key), std::forward<SubscribeArgs>(subscribe_args)...);
+    }
+
+    template <typename... SubscribeArgs>
+    auto on(std::string_view event_name, SubscribeArgs&&... subscribe_args) {
+        return on(Channel<>(resolve<>(event_name, event_name_hash(event_name))),
+                  std::forward<SubscribeArgs>(subscribe_args)...);
+    }
+
+    template <typename... Args>
+    void off(Channel<Args...> channel, typename EventType<Args...>::HandlerId id) {
+        event<Args...>(channel.index_).unsubscribe(id);
     }
 
+    // Returns whatever the event's emit() returns.
+    template <typename... Args>
+    decltype(auto) emit(Channel<Args...> channel, const typename TypeIdentity<Args>::type&... args) const {
+        return event<Args...>(channel.index_).emit(args...);
+    }
+
+    // A no-op for names nothing has subscribed to or resolved.
+    template <typename... Args>
+    void emit(const EventKey<Args...>& key, const typename TypeIdentity<Args>::type&... args) const {
+        std::uint32_t index = find<Args...>(key.name, key.hash);
+        if (index != kMissing) event<Args...>(index).emit(args...);
+    }
+
+    void emit(std::string_view event_name) const {
+        std::uint32_t index = find<>(event_name, event_name_hash(event_name));
+        if (index != kMissing) event<>(index).emit();
+    }
+
+    std::size_t channel_count() const { return channels_.size(); }
+
 private:
-    struct Entry {
-        std::size_t id;
-        std::function<void()> handler;
+    static constexpr std::uint32_t kMissing = ~std::uint32_t{0};
+
+    struct ChannelBase {
+        virtual ~ChannelBase() = default;
+        const void* type = nullptr;
+        std::string name;
     };
-    std::unordered_map<std::string, std::vector<Entry>> events_;
-    std::size_t next_id_ = 0;
+
+    template <typename... Args>
+    struct TypedChannel : ChannelBase {
+        EventType<Args...> event;
+    };
+
+    // One address per argument list, to check channel types without RTTI.
+    template <typename... Args>
+    static const void* type_tag() {
+        static const char tag = 0;
+        return &tag;
+    }
+
+    template <typename... Args>
+    EventType<Args...>& event(std::uint32_t index) const {
+        return static_cast<TypedChannel<Args...>&>(*channels_[index]).event;
+    }
+
+    template <typename... Args>
+    std::uint32_t find(std::string_view name, std::uint64_t hash) const {
+        auto it = index_.find(hash);
+        if (it == index_.end() || channels_[it->second]->name != name) return kMissing;
+        check_type<Args...>(*channels_[it->second]);
+        return it->second;
+    }
+
+    template <typename... Args>
+    std::uint32_t resolve(std::string_view name, std::uint64_t hash) {
+        auto it = index_.find(hash);
+        if (it != index_.end()) {
+            const ChannelBase& existing = *channels_[it->second];
+            if (existing.name != name) {
+                throw std::invalid_argument("event names '" + existing.name + "' and '" + std::string(name) +
+                                            "' have the same hash");
+            }
+            check_type<Args...>(existing);
+            return it->second;
+        }
+        auto created = std::make_unique<TypedChannel<Args...>>();
+        created->type = type_tag<Args...>();
+        created->name = std::string(name);
+        auto index = static_cast<std::uint32_t>(channels_.size());
+        channels_.push_back(std::move(created));
+        index_.emplace(hash, index);
+        return index;
+    }
+
+    template <typename... Args>
+    static void check_type(const ChannelBase& channel) {
+        if (channel.type != type_tag<Args...>()) {
+            throw std::invalid_argument("event '" + channel.name + "' is registered with other argument types");
+        }
+    }
+
+    std::vector<std::unique_ptr<ChannelBase>> channels_;
+    std::unordered_map<std::uint64_t, std::uint32_t> index_;
 };
 
+using EventBus = BasicEventBus<>;
+
 }  // namespace events
 
 #endif  // EVENT_HPP
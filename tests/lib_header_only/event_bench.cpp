@@ -0,0 +1,558 @@
+// Benchmarks for the header-only event library
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <string>
+#include <thread>
+#include <vector>
+#include "async_event.hpp"
+#include "concurrent_event.hpp"
+#include "event.hpp"
+#include "shm_event.hpp"
+
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Counts heap allocations so each row can report allocations per operation.
+// Atomic because emit_rate() workers and AsyncConsumer threads allocate
+// alongside the main thread; the relaxed add costs nothing next to malloc().
+// Kept out of line: once inlined, GCC pairs malloc()/free() with operator
+// new/delete and warns about mismatched deallocation.
+static std::atomic<std::size_t> g_allocations{0};
+
+__attribute__((noinline)) void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+// Runs fn in growing batches until one batch takes at least ~100 ms and
+// returns ns per call along with heap allocations per call.
+template <typename Fn>
+double time_ns(Fn&& fn, double& allocations) {
+    using clock = std::chrono::steady_clock;
+    for (std::size_t batch = 1;; batch *= 2) {
+        std::size_t before = g_allocations;
+        auto start = clock::now();
+        for (std::size_t i = 0; i < batch; ++i) fn();
+        auto elapsed = clock::now() - start;
+        if (elapsed >= std::chrono::milliseconds(100)) {
+            allocations = static_cast<double>(g_allocations - before) / static_cast<double>(batch);
+            return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(batch);
+        }
+    }
+}
+
+void report(const char* name, double ns, double allocations) {
+    std::cout << "  " << std::left << std::setw(34) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(9) << ns << " ns  " << std::setprecision(2) << std::setw(6) << allocations
+              << " allocs\n";
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::setprecision(6);
+}
+
+volatile long g_sink;
+
+constexpr int kHandlers = 8;
+
+// Three words of capture: past libstdc++'s 16-byte std::function buffer,
+// well inside a Delegate.
+template <typename EventType>
+void subscribe_all(EventType& event, long* total) {
+    for (int i = 0; i < kHandlers; ++i) {
+        long scale = i + 1;
+        long bias = i;
+        event.subscribe([total, scale, bias](int v) { *total += v * scale + bias; });
+    }
+}
+
+template <typename EventType>
+void bench_event(const char* label) {
+    std::cout << "\n--- " << label << " ---\n";
+    double allocations = 0;
+    long total = 0;
+    double ns = time_ns([&] {
+        EventType event;
+        subscribe_all(event, &total);
+    }, allocations);
+    report("subscribe 8 handlers (fresh event)", ns, allocations);
+
+    EventType event;
+    subscribe_all(event, &total);
+    int v = 0;
+    ns = time_ns([&] { event.emit(++v); }, allocations);
+    report("emit to 8 handlers", ns, allocations);
+    g_sink = total;
+}
+
+// A 64 KB message that counts its copies.
+struct Message {
+    static std::size_t copies;
+    std::vector<char> body = std::vector<char>(64 * 1024, 'x');
+    Message() = default;
+    Message(const Message& other) : body(other.body) { ++copies; }
+    Message(Message&&) noexcept = default;
+};
+std::size_t Message::copies = 0;
+
+template <typename EventType, typename MakeArg>
+void bench_delivery(const char* name, MakeArg&& make_arg) {
+    EventType event;
+    long total = 0;
+    for (int i = 0; i < kHandlers; ++i) {
+        event.subscribe([&total](const auto& message) { total += static_cast<long>(sizeof(message)); });
+    }
+    auto arg = make_arg();
+    double allocations = 0;
+    std::size_t copies_before = Message::copies;
+    std::size_t emits = 0;
+    double ns = time_ns([&] {
+        event.emit(arg);
+        ++emits;
+    }, allocations);
+    std::cout << "  " << std::left << std::setw(34) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(9) << ns << " ns  " << std::setprecision(2) << std::setw(6)
+              << static_cast<double>(Message::copies - copies_before) / static_cast<double>(emits)
+              << " copies/emit\n";
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::setprecision(6);
+    g_sink = total;
+}
+
+// The previous Event: handlers in a vector, unsubscribe by remove_if.
+template <typename... Args>
+class VectorEvent {
+public:
+    using HandlerId = std::size_t;
+
+    template <typename Func>
+    HandlerId subscribe(Func&& handler) {
+        handlers_.push_back({next_id_, std::forward<Func>(handler)});
+        return next_id_++;
+    }
+
+    void unsubscribe(HandlerId id) {
+        handlers_.erase(std::remove_if(handlers_.begin(), handlers_.end(), [id](const Entry& e) { return e.id == id; }),
+                        handlers_.end());
+    }
+
+    void emit(Args... args) const {
+        for (const auto& entry : handlers_) entry.handler(args...);
+    }
+
+private:
+    struct Entry {
+        HandlerId id;
+        std::function<void(Args...)> handler;
+    };
+    std::vector<Entry> handlers_;
+    HandlerId next_id_ = 0;
+};
+
+// Short-lived subscriptions: `live` handlers stay subscribed while each
+// step retires the oldest and subscribes a replacement; every 16th step
+// also emits.
+template <typename EventType>
+void bench_churn(const char* name, std::size_t live) {
+    EventType event;
+    long total = 0;
+    std::deque<typename EventType::HandlerId> ids;
+    for (std::size_t i = 0; i < live; ++i) ids.push_back(event.subscribe([&total](int v) { total += v; }));
+    std::size_t step = 0;
+    double allocations = 0;
+    double ns = time_ns([&] {
+        event.unsubscribe(ids.front());
+        ids.pop_front();
+        ids.push_back(event.subscribe([&total](int v) { total += v; }));
+        if (++step % 16 == 0) event.emit(1);
+    }, allocations);
+    report(name, ns, allocations);
+    g_sink = total;
+}
+
+// The previous EventBus: string keys, hashed and compared on every emit.
+class StringBus {
+public:
+    template <typename Func>
+    void on(const std::string& event_name, Func&& handler) {
+        events_[event_name].push_back(std::forward<Func>(handler));
+    }
+    void emit(const std::string& event_name) {
+        auto it = events_.find(event_name);
+        if (it != events_.end()) {
+            for (const auto& handler : it->second) handler();
+        }
+    }
+
+private:
+    std::unordered_map<std::string, std::vector<std::function<void()>>> events_;
+};
+
+// What callers did before ConcurrentEvent: one lock around a plain Event.
+class LockedEvent {
+public:
+    template <typename Func>
+    void subscribe(Func&& handler) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        event_.subscribe(std::forward<Func>(handler));
+    }
+    void emit(int v) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        event_.emit(v);
+    }
+
+private:
+    mutable std::mutex mutex_;
+    events::Event<int> event_;
+};
+
+thread_local long t_sum = 0;
+
+// Total emits per second with `threads` threads emitting to 4 handlers.
+template <typename EventType>
+double emit_rate(unsigned threads) {
+    EventType event;
+    for (int i = 0; i < 4; ++i) event.subscribe([](int v) { t_sum += v; });
+    constexpr int kEmits = 200000;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&event] {
+            for (int i = 0; i < kEmits; ++i) event.emit(i);
+            g_sink = t_sum;
+        });
+    }
+    for (auto& w : workers) w.join();
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(kEmits) * threads / s;
+}
+
+// Busy-waits for `ns`: a subscriber with real work to do.
+void spin_for(long ns) {
+    auto until = std::chrono::steady_clock::now() + std::chrono::nanoseconds(ns);
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+constexpr long kSlowHandlerNs = 2000;
+
+// Times every emit separately: the producer's publish cost, whatever the
+// subscriber costs.
+void bench_async_producer(const char* name, events::Overflow overflow) {
+    constexpr events::EventKey<int> kSample{"sample"};
+    events::AsyncEventBus bus;
+    events::AsyncConsumer consumer({4096, overflow, 64, true});
+    long total = 0;
+    auto sample = bus.channel(kSample);
+    bus.on(sample, consumer, [&total](int v) {
+        spin_for(kSlowHandlerNs);
+        total += v;
+    });
+    events::LatencyHistogram publish;
+    double allocations = 0;
+    double ns = time_ns([&] {
+        auto start = std::chrono::steady_clock::now();
+        bus.emit(sample, 1);
+        publish.record(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+    }, allocations);
+    report(name, ns, allocations);
+    std::cout << "      publish p50 " << publish.percentile(0.5) << " ns, p99 " << publish.percentile(0.99)
+              << " ns, p99.9 " << publish.percentile(0.999) << " ns\n";
+    consumer.flush();
+    g_sink = total;
+}
+
+void print_async_stats(const char* name, const events::AsyncStats& s) {
+    std::cout << "  " << std::left << std::setw(22) << name << std::right << std::setw(9) << s.p50_ns << std::setw(10)
+              << s.p99_ns << std::setw(10) << s.p999_ns << std::setw(10) << s.max_ns << std::setw(7) << s.max_depth
+              << std::setw(9) << s.delivered << std::setw(8) << s.dropped << std::setw(8) << s.batches << "\n";
+}
+
+// ── Cross-process transports ───────────────────────────────────────────────
+// A child process echoes each 64-byte event back (round trips) or counts a
+// one-way stream and reports when it has all of it. The first byte of an
+// event is 1 for "stop".
+constexpr std::size_t kWireSize = 64;
+constexpr int kRoundTrips = 20000;
+constexpr int kStreamEvents = 1000000;
+
+struct TransportResult {
+    events::LatencyHistogram rtt;
+    double rtt_mean_ns = 0;
+    double events_per_s = 0;
+};
+
+bool read_full(int fd, void* buffer, std::size_t size) {
+    auto* p = static_cast<char*>(buffer);
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+bool write_full(int fd, const void* buffer, std::size_t size) {
+    auto* p = static_cast<const char*>(buffer);
+    while (size > 0) {
+        ssize_t n = write(fd, p, size);
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+std::uint64_t elapsed_ns(std::chrono::steady_clock::time_point start) {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+// Two segments, ping and pong. The parent joins pong before forking so the
+// child's first echo cannot be missed; the child joins ping and says so
+// over a pipe.
+void shm_transport(TransportResult& result) {
+    std::string prefix = "/event_bench_" + std::to_string(getpid());
+    events::ShmSegment ping(prefix + "_ping", {kWireSize, 1024});
+    events::ShmSegment pong(prefix + "_pong", {kWireSize, 1024});
+    events::ShmSubscriber replies(pong);
+    int ready[2];
+    if (pipe(ready) != 0) return;
+    pid_t child = fork();
+    if (child == 0) {
+        events::ShmSegment in(prefix + "_ping");
+        events::ShmSegment out(prefix + "_pong");
+        events::ShmSubscriber requests(in);
+        events::ShmPublisher echo(out);
+        char c = 1;
+        if (!write_full(ready[1], &c, 1)) _exit(1);
+        for (int phase = 0; phase < 2; ++phase) {
+            long received = 0;
+            bool stop = false;
+            while (!stop) {
+                requests.wait(std::chrono::milliseconds(100));
+                requests.poll([&](const void* data, std::size_t size) {
+                    stop = static_cast<const char*>(data)[0] == 1;
+                    ++received;
+                    if (phase == 0) echo.publish(data, size);
+                });
+            }
+            if (phase == 1 && !write_full(ready[1], &received, sizeof(received))) _exit(1);
+        }
+        _exit(0);
+    }
+    char c;
+    if (!read_full(ready[0], &c, 1)) return;
+    ping.unlink();
+    pong.unlink();
+    events::ShmPublisher requests(ping);
+    char message[kWireSize] = {};
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kRoundTrips; ++i) {
+        message[0] = i + 1 == kRoundTrips;
+        auto sent = std::chrono::steady_clock::now();
+        requests.publish(message, kWireSize);
+        while (replies.poll([](const void*, std::size_t) {}, 1) == 0) replies.wait(std::chrono::milliseconds(100));
+        result.rtt.record(elapsed_ns(sent));
+    }
+    result.rtt_mean_ns = static_cast<double>(elapsed_ns(start)) / kRoundTrips;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kStreamEvents; ++i) {
+        message[0] = i + 1 == kStreamEvents;
+        requests.publish(message, kWireSize);
+    }
+    long received = 0;
+    if (read_full(ready[0], &received, sizeof(received)) && received == kStreamEvents) {
+        result.events_per_s = kStreamEvents / (static_cast<double>(elapsed_ns(start)) / 1e9);
+    }
+    waitpid(child, nullptr, 0);
+    close(ready[0]);
+    close(ready[1]);
+    return;
+}
+
+void socket_transport(TransportResult& result) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) return;
+    pid_t child = fork();
+    if (child == 0) {
+        close(fds[0]);
+        char message[kWireSize];
+        do {
+            if (!read_full(fds[1], message, kWireSize) || !write_full(fds[1], message, kWireSize)) _exit(1);
+        } while (message[0] != 1);
+        long received = 0;
+        do {
+            if (!read_full(fds[1], message, kWireSize)) _exit(1);
+            ++received;
+        } while (message[0] != 1);
+        if (!write_full(fds[1], &received, sizeof(received))) _exit(1);
+        _exit(0);
+    }
+    close(fds[1]);
+    char message[kWireSize] = {};
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kRoundTrips; ++i) {
+        message[0] = i + 1 == kRoundTrips;
+        auto sent = std::chrono::steady_clock::now();
+        if (!write_full(fds[0], message, kWireSize) || !read_full(fds[0], message, kWireSize)) return;
+        result.rtt.record(elapsed_ns(sent));
+    }
+    result.rtt_mean_ns = static_cast<double>(elapsed_ns(start)) / kRoundTrips;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kStreamEvents; ++i) {
+        message[0] = i + 1 == kStreamEvents;
+        if (!write_full(fds[0], message, kWireSize)) return;
+    }
+    long received = 0;
+    if (read_full(fds[0], &received, sizeof(received)) && received == kStreamEvents) {
+        result.events_per_s = kStreamEvents / (static_cast<double>(elapsed_ns(start)) / 1e9);
+    }
+    waitpid(child, nullptr, 0);
+    close(fds[0]);
+    return;
+}
+
+void print_transport(const char* name, const TransportResult& r) {
+    std::cout << "  " << std::left << std::setw(20) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << r.rtt.percentile(0.5) / 1000.0 << std::setw(10) << r.rtt.percentile(0.99) / 1000.0
+              << std::setw(10) << r.rtt_mean_ns / 1000.0 << std::setw(12) << std::setprecision(2)
+              << r.events_per_s / 1e6 << "\n";
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::setprecision(6);
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "=== event benchmark ===\n";
+    std::cout << "sizeof std::function<void(int)>: " << sizeof(std::function<void(int)>)
+              << ", sizeof Delegate<void(int)>: " << sizeof(events::Delegate<void(int)>) << "\n";
+
+    bench_event<events::BasicEvent<std::function<void(int)>, int>>("std::function handlers");
+    bench_event<events::Event<int>>("Delegate handlers");
+
+    for (std::size_t live : {16, 1000}) {
+        std::cout << "\n--- churn, " << live << " live handlers (per unsubscribe + subscribe) ---\n";
+        bench_churn<VectorEvent<int>>("vector + remove_if", live);
+        bench_churn<events::Event<int>>("slot map", live);
+    }
+
+    {
+        std::cout << "\n--- EventBus emit, 24 events registered, 1 handler ---\n";
+        const std::string names[] = {"sensor.temperature", "sensor.pressure", "sensor.humidity", "link.up",
+                                     "link.down", "motor.stall", "motor.start", "motor.stop"};
+        StringBus old_bus;
+        events::EventBus bus;
+        long total = 0;
+        for (int copy = 0; copy < 3; ++copy) {
+            for (const auto& name : names) {
+                std::string n = name + (copy ? std::to_string(copy) : "");
+                old_bus.on(n, [&total] { ++total; });
+                bus.on(n, [&total] { ++total; });
+            }
+        }
+        constexpr events::EventKey<> kTemperature{"sensor.temperature"};
+        auto temperature = bus.channel(kTemperature);
+        double allocations = 0;
+        double ns = time_ns([&] { old_bus.emit("sensor.temperature"); }, allocations);
+        report("std::string key (old bus)", ns, allocations);
+        ns = time_ns([&] { bus.emit("sensor.temperature"); }, allocations);
+        report("string_view name", ns, allocations);
+        ns = time_ns([&] { bus.emit(kTemperature); }, allocations);
+        report("EventKey (compile-time hash)", ns, allocations);
+        ns = time_ns([&] { bus.emit(temperature); }, allocations);
+        report("Channel (resolved index)", ns, allocations);
+        g_sink = total;
+    }
+
+    {
+        std::cout << "\n--- EventBus vs AsyncEventBus, one " << kSlowHandlerNs << " ns subscriber (per emit) ---\n";
+        constexpr events::EventKey<int> kSample{"sample"};
+        events::EventBus bus;
+        long total = 0;
+        auto sample = bus.channel(kSample);
+        bus.on(sample, [&total](int v) {
+            spin_for(kSlowHandlerNs);
+            total += v;
+        });
+        double allocations = 0;
+        double ns = time_ns([&] { bus.emit(sample, 1); }, allocations);
+        report("EventBus (synchronous)", ns, allocations);
+        g_sink = total;
+        bench_async_producer("AsyncEventBus, DropOldest", events::Overflow::DropOldest);
+        bench_async_producer("AsyncEventBus, Fail", events::Overflow::Fail);
+        bench_async_producer("AsyncEventBus, Block", events::Overflow::Block);
+
+        // Bursts of 512 events, one every 2 ms, so the consumer keeps up on
+        // average: emit-to-handler latency is queueing behind the burst.
+        std::cout << "\n--- AsyncEventBus consumer, 512-event bursts (ns; depth in events) ---\n";
+        std::cout << "  subscriber cost             p50       p99     p99.9       max  depth delivered dropped batches\n";
+        for (long handler_ns : {0L, 200L, kSlowHandlerNs}) {
+            events::AsyncEventBus async_bus;
+            events::AsyncConsumer consumer({1024, events::Overflow::DropOldest, 64, true});
+            async_bus.on(kSample, consumer, [handler_ns, &total](int v) {
+                if (handler_ns) spin_for(handler_ns);
+                total += v;
+            });
+            auto channel = async_bus.channel(kSample);
+            for (int burst = 0; burst < 50; ++burst) {
+                for (int i = 0; i < 512; ++i) async_bus.emit(channel, i);
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+            consumer.flush();
+            print_async_stats((std::to_string(handler_ns) + " ns").c_str(), consumer.stats());
+        }
+        g_sink = total;
+    }
+
+    std::cout << "\n--- cross-process, " << kWireSize << "-byte events (us; M events/s one way) ---\n";
+    std::cout << "  transport              rtt p50   rtt p99  rtt mean      stream\n";
+    {
+        TransportResult shm, socket;
+        shm_transport(shm);
+        socket_transport(socket);
+        print_transport("shared memory", shm);
+        print_transport("Unix-domain socket", socket);
+    }
+
+    std::cout << "\n--- emit throughput, 4 handlers (M emits/s, all threads) ---\n";
+    std::cout << "  threads   mutex + Event   ConcurrentEvent\n";
+    for (unsigned threads : {1u, 2u, 4u, 8u, 16u}) {
+        std::cout << std::fixed << std::setprecision(2) << "  " << std::setw(7) << threads << std::setw(16)
+                  << emit_rate<LockedEvent>(threads) / 1e6 << std::setw(18)
+                  << emit_rate<events::ConcurrentEvent<int>>(threads) / 1e6 << "\n";
+        std::cout.unsetf(std::ios::fixed);
+        std::cout << std::setprecision(6);
+    }
+    std::cout << "  (hardware threads: " << std::thread::hardware_concurrency() << ")\n";
+
+    // The first row is the old Event<Message>: its handler signature took
+    // the message by value, so every handler got its own copy.
+    std::cout << "\n--- 64 KB message to 8 handlers ---\n";
+    bench_delivery<events::BasicEvent<std::function<void(Message)>, Message>>("by-value handler signature",
+                                                                              [] { return Message(); });
+    bench_delivery<events::Event<Message>>("const Message& (Event<Message>)", [] { return Message(); });
+    bench_delivery<events::Event<events::Payload<Message>>>("Payload<Message> handle",
+                                                            [] { return events::make_payload<Message>(); });
+
+    std::cout << "\nevent benchmark done.\n";
+    return 0;
+}
@@ -2,7 +2,50 @@
 #include <iostream>
 #include <string>
 #include <unordered_map>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "async_event.hpp"
+#include "concurrent_event.hpp"
 #include "event.hpp"
+#include "shm_event.hpp"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Counts heap allocations so the delegate checks can assert on them. The
+// ConcurrentEvent emitters and AsyncEventBus producers and consumers
+// allocate on their own threads.
+static std::atomic<std::size_t> g_allocations{0};
+
+// noinline: with these inlined, GCC sees new'd memory reach free() and
+// raises -Wmismatched-new-delete at -O1 and above.
+__attribute__((noinline)) void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+static int g_free_calls = 0;
+static void count_free_call(int code) { g_free_calls += code; }
+
+// Counts copies so the payload checks can assert there are none.
+static int g_copies = 0;
+
+struct Tracked {
+    int value = 0;
+    Tracked() = default;
+    Tracked(const Tracked& other) : value(other.value) { ++g_copies; }
+};
 
 int main() {
     std::cout << "=== Header-only library test ===\n";
@@ -14,7 +57,7 @@ int main() {
         std::cout << "  handler1: code=" << code << " msg=" << msg << "\n";
     });
 
-    auto id2 = on_message.subscribe([](int code, const std::string& msg) {
+    [[maybe_unused]] auto id2 = on_message.subscribe([](int code, const std::string& msg) {
         std::cout << "  handler2: code=" << code << " msg=" << msg << "\n";
     });
 
@@ -40,6 +83,311 @@ int main() {
     bus.emit("stop");
     bus.emit("nonexistent");  // should be a no-op
 
+    // Typed keys and resolved channels
+    {
+        constexpr events::EventKey<int, std::string> kStatus{"status"};
+        static_assert(kStatus.hash == events::event_name_hash("status"), "key hashes at compile time");
+        std::string log;
+        auto status = bus.channel(kStatus);
+        bus.on(kStatus, [&](int code, const std::string& text) { log += std::to_string(code) + text + ";"; });
+        auto id = bus.on(status, [&](int code, const std::string&) { log += code == 500 ? "!" : ""; });
+        bus.emit(kStatus, 200, "OK");
+        bus.emit(status, 500, "Error");
+        bus.off(status, id);
+        bus.emit(status, 503, "Busy");
+
+        bool mismatch_thrown = false;
+        try {
+            bus.channel(events::EventKey<double>{"status"});
+        } catch (const std::invalid_argument&) {
+            mismatch_thrown = true;
+        }
+        bool ok = log == "200OK;500Error;!503Busy;" && mismatch_thrown && bus.channel_count() == 3;
+        std::cout << "typed bus: " << log << (ok ? "" : " (MISMATCH)") << "\n";
+        if (!ok) return 1;
+    }
+
+    // Delegate: free functions, move-only captures, no allocation, and
+    // the std::function-backed event for oversized captures
+    std::cout << "\n=== Delegate ===\n";
+    {
+        struct Big {
+            char bytes[256];
+        };
+        using Small = events::Delegate<void(int)>;
+        static_assert(Small::fits<void (*)(int)>, "function pointers fit");
+        static_assert(!Small::fits<Big>, "oversized captures are rejected");
+
+        auto owned = std::make_unique<int>(5);
+        std::size_t before = g_allocations;
+        int total = 0;
+        Small free_fn(&count_free_call);
+        Small move_only([p = std::move(owned), &total](int v) { total += *p * v; });
+        Small moved(std::move(move_only));
+        free_fn(3);
+        moved(2);
+        std::size_t allocations = g_allocations - before;
+        bool ok = allocations == 0 && g_free_calls == 3 && total == 10 && !move_only && moved;
+
+        bool threw = false;
+        try {
+            move_only(1);
+        } catch (const std::bad_function_call&) {
+            threw = true;
+        }
+
+        events::BasicEvent<std::function<void(int)>, int> wide;
+        Big big{};
+        big.bytes[0] = 7;
+        wide.subscribe([big, &total](int v) { total += big.bytes[0] * v; });
+        wide.emit(1);
+        ok = ok && threw && total == 17;
+        std::cout << "delegate: " << sizeof(Small) << " bytes, " << allocations << " allocations"
+                  << (ok ? "" : " (MISMATCH)") << "\n";
+        if (!ok) return 1;
+    }
+
+    // Arguments reach every handler by const reference; large messages go
+    // by handle
+    std::cout << "\n=== Payloads ===\n";
+    {
+        events::Event<Tracked> on_tracked;
+        int seen = 0;
+        for (int i = 0; i < 3; ++i) on_tracked.subscribe([&seen](const Tracked& t) { seen += t.value; });
+        Tracked t;
+        t.value = 4;
+        on_tracked.emit(t);
+
+        events::Event<events::Payload<Tracked>> on_payload;
+        events::Payload<Tracked> kept;
+        on_payload.subscribe([&kept](const events::Payload<Tracked>& p) { kept = p; });
+        on_payload.subscribe([&seen](const events::Payload<Tracked>& p) { seen += p->value; });
+        on_payload.emit(events::make_payload<Tracked>());
+
+        events::Event<int&> on_counter;
+        on_counter.subscribe([](int& n) { ++n; });
+        on_counter.subscribe([](int& n) { n *= 10; });
+        int counter = 1;
+        on_counter.emit(counter);
+
+        bool ok = g_copies == 0 && seen == 12 && kept && kept.use_count() == 1 && counter == 20;
+        std::cout << "payloads: " << g_copies << " copies for " << on_tracked.subscriber_count()
+                  << " handlers" << (ok ? "" : " (MISMATCH)") << "\n";
+        if (!ok) return 1;
+    }
+
+    // Handlers changing the subscriber list mid-emit, and stale IDs
+    std::cout << "\n=== Re-entrant emit ===\n";
+    {
+        events::Event<int> on_tick;
+        std::string trace;
+        events::Event<int>::HandlerId self = 0, victim = 0;
+        on_tick.subscribe([&](int) { trace += 'a'; });
+        self = on_tick.subscribe([&](int) {
+            trace += 'b';
+            on_tick.unsubscribe(self);
+            on_tick.unsubscribe(victim);
+            on_tick.subscribe([&](int) { trace += 'e'; });
+        });
+        victim = on_tick.subscribe([&](int) { trace += 'c'; });
+        on_tick.subscribe([&](int) { trace += 'd'; });
+        on_tick.emit(1);
+        trace += '|';
+        on_tick.emit(2);
+
+        // The freed slot is reused; the stale ID must not remove its new owner.
+        auto fresh = on_tick.subscribe([&](int) { trace += 'f'; });
+        on_tick.unsubscribe(victim);
+        trace += '|';
+        on_tick.emit(3);
+        on_tick.unsubscribe(fresh);
+        bool ok = trace == "abd|ade|adef" && on_tick.subscriber_count() == 3;
+        std::cout << "re-entrant: " << trace << (ok ? "" : " (MISMATCH)") << "\n";
+        if (!ok) return 1;
+    }
+
+    // Concurrent emitters while another thread keeps replacing handlers
+    std::cout << "\n=== ConcurrentEvent ===\n";
+    {
+        events::ConcurrentEvent<int> on_sample;
+        std::atomic<long> permanent{0}, transient{0};
+        on_sample.subscribe([&](int v) { permanent.fetch_add(v, std::memory_order_relaxed); });
+        std::atomic<bool> done{false};
+        std::thread writer([&] {
+            while (!done.load()) {
+                auto id = on_sample.subscribe([&](int v) { transient.fetch_add(v, std::memory_order_relaxed); });
+                on_sample.unsubscribe(id);
+            }
+        });
+        std::vector<std::thread> emitters;
+        for (int t = 0; t < 4; ++t) {
+            emitters.emplace_back([&] {
+                for (int i = 0; i < 20000; ++i) on_sample.emit(1);
+            });
+        }
+        for (auto& t : emitters) t.join();
+        done.store(true);
+        writer.join();
+        on_sample.synchronize();
+        bool ok = permanent.load() == 80000 && on_sample.subscriber_count() == 1 && on_sample.retired_count() == 0;
+        std::cout << "concurrent: " << permanent.load() << " deliveries from 4 threads"
+                  << (ok ? "" : " (MISMATCH)") << "\n";
+        if (!ok) return 1;
+    }
+
+    // Async bus: two producers, two consumer threads, then the overflow
+    // policies on consumers drained by hand
+    std::cout << "\n=== AsyncEventBus ===\n";
+    {
+        constexpr events::EventKey<int> kTick{"tick"};
+        events::AsyncEventBus async_bus;
+        events::AsyncConsumer fast, slow;
+        auto tick = async_bus.channel(kTick);
+        long fast_sum = 0, slow_sum = 0;
+        async_bus.on(tick, fast, [&](int v) { fast_sum += v; });
+        async_bus.on(kTick, slow, [&](int v) {
+            std::this_thread::sleep_for(std::chrono::microseconds(v % 1000 == 0 ? 100 : 0));
+            slow_sum += v;
+        });
+        std::vector<std::thread> producers;
+        for (int t = 0; t < 2; ++t) {
+            producers.emplace_back([&] {
+                for (int i = 1; i <= 5000; ++i) async_bus.emit(tick, i);
+            });
+        }
+        for (auto& t : producers) t.join();
+        fast.flush();
+        slow.flush();
+        auto stats = slow.stats();
+        bool ok = fast_sum == 2 * 12502500L && slow_sum == fast_sum && stats.delivered == 10000 &&
+                  stats.depth == 0 && stats.max_ns >= stats.p50_ns;
+        std::cout << "async: " << fast_sum << " on both consumers, slow p50 " << stats.p50_ns << " ns, max depth "
+                  << stats.max_depth << (ok ? "" : " (MISMATCH)") << "\n";
+        if (!ok) return 1;
+
+        std::string seen;
+        events::AsyncConsumer failing({4, events::Overflow::Fail, 64, false});
+        events::AsyncConsumer dropping({4, events::Overflow::DropOldest, 64, false});
+        events::AsyncEvent<int> on_code;
+        on_code.subscribe(failing, [&](int v) { seen += "f" + std::to_string(v); });
+        on_code.subscribe(dropping, [&](int v) { seen += "d" + std::to_string(v); });
+        int accepted = 0;
+        for (int i = 1; i <= 6; ++i) accepted += on_code.emit(i);
+        failing.drain(16);
+        dropping.drain(16);
+        ok = accepted == 4 && seen == "f1f2f3f4d3d4d5d6" && failing.stats().rejected == 2 &&
+             dropping.stats().dropped == 2;
+        std::cout << "overflow: " << seen << (ok ? "" : " (MISMATCH)") << "\n";
+        if (!ok) return 1;
+
+        // Tail percentiles round the rank up: one outlier in 500 is p99.9.
+        events::LatencyHistogram latency;
+        for (int i = 0; i < 499; ++i) latency.record(1000);
+        latency.record(1000000);
+        ok = latency.percentile(0.999) == 1000000 && latency.percentile(0.5) < 2000 &&
+             latency.percentile(1.0) == 1000000;
+        std::cout << "latency: p50 " << latency.percentile(0.5) << " ns, p99.9 " << latency.percentile(0.999)
+                  << " ns" << (ok ? "" : " (MISMATCH)") << "\n";
+        if (!ok) return 1;
+    }
+
+    // Shared memory: a child process subscribes, the parent publishes
+    // through a ring much smaller than the stream
+    std::cout << "\n=== Shared memory ===\n";
+    {
+        std::string name = "/header_only_test_" + std::to_string(getpid());
+        events::ShmSegment segment(name, {sizeof(int), 16});
+        int ready[2];
+        if (pipe(ready) != 0) {
+            segment.unlink();
+            return 1;
+        }
+        pid_t child = fork();
+        if (child == 0) {
+            close(ready[0]);
+            try {
+                events::ShmSegment opened(name);
+                events::ShmSubscriber subscriber(opened);
+                char joined = 1;
+                if (write(ready[1], &joined, 1) != 1) _exit(2);
+                long sum = 0;
+                bool done = false;
+                while (!done) {
+                    subscriber.wait(std::chrono::milliseconds(100));
+                    subscriber.poll([&](const void* data, std::size_t size) {
+                        int v;
+                        std::memcpy(&v, data, size);
+                        if (v < 0) done = true;
+                        sum += v < 0 ? 0 : v;
+                    });
+                }
+                _exit(sum == 500500 ? 0 : 1);
+            } catch (const std::exception& e) {
+                std::cerr << "shm child: " << e.what() << "\n";
+                _exit(3);
+            }
+        }
+        // Only the child holds the write end now, so a child that fails
+        // before joining ends the read with EOF instead of a hang.
+        close(ready[1]);
+        char joined;
+        bool started = child > 0 && read(ready[0], &joined, 1) == 1;
+        close(ready[0]);
+        segment.unlink();  // both processes have it mapped now, or the test is over
+        if (!started) {
+            if (child > 0) waitpid(child, nullptr, 0);
+            std::cout << "shm: subscriber process did not start (MISMATCH)\n";
+            return 1;
+        }
+        events::ShmPublisher publisher(segment);
+        for (int i = 1; i <= 1000; ++i) publisher.publish(i);
+        publisher.publish(-1);
+        int status = 0;
+        waitpid(child, &status, 0);
+
+        events::ShmSubscriber idle(segment);
+        events::ShmPublisher failing(segment, events::Overflow::Fail);
+        int accepted = 0;
+        for (int i = 0; i < 20; ++i) accepted += failing.publish(i);
+        std::size_t drained = idle.poll([](const void*, std::size_t) {});
+
+        // A publisher that dies mid-write leaves a hole the subscriber skips.
+        pid_t writer = fork();
+        if (writer == 0) {
+            events::ShmPublisher dying(segment);
+            dying.publish_in_place(sizeof(int), [](void*) { _exit(0); });
+            _exit(1);
+        }
+        int writer_status = 0;
+        waitpid(writer, &writer_status, 0);
+        failing.publish(7);
+        int after_hole = 0;
+        for (int i = 0; i < 1000 && after_hole == 0; ++i) {
+            idle.poll([&](const void* data, std::size_t) { std::memcpy(&after_hole, data, sizeof(int)); });
+        }
+
+        // A subscriber that dies without leaving holds the ring only until
+        // a publisher, Fail ones included, notices and drops it.
+        pid_t reader = fork();
+        if (reader == 0) {
+            events::ShmSubscriber dying(segment);
+            _exit(0);
+        }
+        waitpid(reader, nullptr, 0);
+        for (int i = 0; i < 16; ++i) failing.publish(i);
+        idle.poll([](const void*, std::size_t) {});
+        int refused = 0;
+        while (refused < 1000 && !failing.publish(0)) ++refused;
+
+        bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0 && accepted == 16 && drained == 16 &&
+                  WIFEXITED(writer_status) && WEXITSTATUS(writer_status) == 0 && after_hole == 7 &&
+                  idle.skipped() == 1 && refused > 0 && refused < 1000;
+        std::cout << "shm: child summed 1..1000 through 16 slots, full ring refused " << 20 - accepted
+                  << ", skipped " << idle.skipped() << " slot of a dead publisher, dropped a dead subscriber after "
+                  << refused << " refusals" << (ok ? "" : " (MISMATCH)") << "\n";
+        if (!ok) return 1;
+    }
+
     std::cout << "\nHeader-only library test passed.\n";
     return 0;
 }
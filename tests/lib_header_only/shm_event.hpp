@@ -0,0 +1,525 @@
+// Header-only library: publish/subscribe between processes over shared memory
+#ifndef SHM_EVENT_HPP
+#define SHM_EVENT_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#elif defined(__QNXNTO__)
+#include <sys/neutrino.h>
+#include <sys/netmgr.h>
+#endif
+
+#include "async_event.hpp"
+
+namespace events {
+
+struct ShmOptions {
+    std::size_t slot_size = 256;  // payload bytes per event
+    std::size_t slots = 1024;     // rounded up to a power of two
+};
+
+// ── Segment ─────────────────────────────────────────────────────────────────
+// A named POSIX shared memory object holding one broadcast ring: a header
+// with the publish position and a table of subscribers, then fixed-size
+// slots. Publishers in any process claim slots with a CAS on the shared
+// tail; every subscriber reads every event, in place, behind its own cursor,
+// and a slot is reused only once all subscribers have passed it.
+//
+// Throws std::runtime_error when the object cannot be created, opened or
+// mapped, or is not a segment of this version. The segment must outlive the
+// publishers and subscribers using it.
+class ShmSegment {
+public:
+    static constexpr std::uint32_t kMaxSubscribers = 16;
+
+    // Creates the object; fails if `name` exists. Call unlink() when done.
+    ShmSegment(const std::string& name, const ShmOptions& options) : name_(name) {
+        std::size_t slots = 2;
+        while (slots < options.slots) slots *= 2;
+        if (options.slot_size == 0 || options.slot_size > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::invalid_argument("ShmOptions::slot_size must be between 1 and 2^32 - 1");
+        }
+        std::size_t stride = round_up(sizeof(Slot) + options.slot_size, 64);
+        size_ = round_up(sizeof(Header), 64) + slots * stride;
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) throw sys_error("cannot create", name);
+        if (ftruncate(fd, static_cast<off_t>(size_)) != 0) {
+            close(fd);
+            shm_unlink(name.c_str());
+            throw sys_error("cannot size", name);
+        }
+        try {
+            map(fd);
+        } catch (...) {
+            shm_unlink(name.c_str());
+            throw;
+        }
+        header_ = ::new (base_) Header;
+        header_->slot_size = options.slot_size;
+        header_->slots = slots;
+        header_->stride = stride;
+        header_->magic = kMagic;
+        header_->ready.store(1, std::memory_order_release);
+    }
+
+    // Opens an existing object, waiting up to a second for its creator to
+    // finish setting it up.
+    explicit ShmSegment(const std::string& name) : name_(name) {
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0) throw sys_error("cannot open", name);
+        struct stat st;
+        for (int attempt = 0;; ++attempt) {
+            if (fstat(fd, &st) != 0) {
+                close(fd);
+                throw sys_error("cannot stat", name);
+            }
+            if (static_cast<std::size_t>(st.st_size) >= sizeof(Header)) break;
+            if (attempt == 1000) {
+                close(fd);
+                throw std::runtime_error("shared memory " + name + " was never initialized");
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        map(fd);
+        header_ = static_cast<Header*>(base_);
+        const char* problem = nullptr;
+        for (int attempt = 0; header_->ready.load(std::memory_order_acquire) == 0; ++attempt) {
+            if (attempt == 1000) {
+                problem = " was never initialized";
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (problem == nullptr && (header_->magic != kMagic || header_->slots == 0 ||
+                                   round_up(sizeof(Header), 64) + header_->slots * header_->stride != size_)) {
+            problem = " is not an event segment";
+        }
+        if (problem != nullptr) {
+            munmap(base_, size_);
+            throw std::runtime_error("shared memory " + name + problem);
+        }
+    }
+
+    ~ShmSegment() { munmap(base_, size_); }
+
+    ShmSegment(const ShmSegment&) = delete;
+    ShmSegment& operator=(const ShmSegment&) = delete;
+
+    // Removes the name; processes that have it mapped keep using it.
+    void unlink() { shm_unlink(name_.c_str()); }
+
+    std::size_t slot_size() const { return static_cast<std::size_t>(header_->slot_size); }
+    std::size_t slots() const { return static_cast<std::size_t>(header_->slots); }
+    std::uint64_t published() const { return header_->tail.load(std::memory_order_relaxed); }
+
+private:
+    friend class ShmPublisher;
+    friend class ShmSubscriber;
+
+    static constexpr std::uint64_t kMagic = 0x31746e6576456d53ULL;  // "SmEvent1"
+
+    enum : std::uint32_t { kFree = 0, kJoining = 1, kActive = 2 };
+
+    // One per subscriber. `state` packs the owner's pid, a generation
+    // bumped on every join and the phase into one word, so a publisher
+    // reaping a dead subscriber frees the entry with a CAS from exactly the
+    // word it checked and never frees a newcomer that took it over since.
+    // `wake` is the futex word on Linux; on QNX a publisher sends a pulse
+    // to (pid, chid).
+    struct alignas(64) Subscriber {
+        std::atomic<std::uint64_t> state{0};
+        std::atomic<std::uint32_t> sleeping{0};
+        std::atomic<std::uint32_t> wake{0};
+        std::int32_t chid = -1;
+        std::atomic<std::uint64_t> cursor{0};  // next sequence to read
+    };
+
+    static std::uint64_t state(std::int32_t pid, std::uint64_t generation, std::uint32_t phase) {
+        return std::uint64_t{static_cast<std::uint32_t>(pid)} << 32 | (generation & 0x3fffffffu) << 2 | phase;
+    }
+    static std::uint32_t phase(std::uint64_t state) { return static_cast<std::uint32_t>(state & 3u); }
+    static std::uint64_t generation(std::uint64_t state) { return state >> 2 & 0x3fffffffu; }
+    static std::int32_t owner(std::uint64_t state) { return static_cast<std::int32_t>(state >> 32); }
+
+    struct Header {
+        std::uint64_t magic = 0;
+        std::uint64_t slot_size = 0;
+        std::uint64_t slots = 0;
+        std::uint64_t stride = 0;
+        std::atomic<std::uint32_t> ready{0};
+        std::atomic<std::uint32_t> sleepers{0};
+        alignas(64) std::atomic<std::uint64_t> tail{0};  // next sequence to claim
+        Subscriber subscribers[kMaxSubscribers];
+    };
+
+    // sequence is 0 until the first publish, then the event's sequence + 1.
+    // claim holds the low 32 bits of the sequence being written and the
+    // writer's pid, so subscribers can tell a slow writer from a dead one.
+    // The payload follows, 16-byte aligned.
+    struct alignas(16) Slot {
+        std::atomic<std::uint64_t> sequence{0};
+        std::atomic<std::uint64_t> claim{0};
+        std::uint64_t size = 0;
+    };
+
+    static std::uint64_t claim(std::uint64_t sequence, std::int32_t pid) {
+        return sequence << 32 | static_cast<std::uint32_t>(pid);
+    }
+
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free && std::atomic<std::uint64_t>::is_always_lock_free,
+                  "shared-memory events need lock-free atomics");
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex words are 32 bits");
+
+    static std::size_t round_up(std::size_t n, std::size_t to) { return (n + to - 1) / to * to; }
+
+    static std::runtime_error sys_error(const char* what, const std::string& name) {
+        return std::runtime_error(std::string(what) + " shared memory " + name + ": " + std::strerror(errno));
+    }
+
+    void map(int fd) {
+        void* p = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        if (p == MAP_FAILED) throw sys_error("cannot map", name_);
+        base_ = p;
+    }
+
+    Slot& slot(std::uint64_t sequence) const {
+        auto* slots = static_cast<unsigned char*>(base_) + round_up(sizeof(Header), 64);
+        return *reinterpret_cast<Slot*>(slots + (sequence & (header_->slots - 1)) * header_->stride);
+    }
+
+    static unsigned char* payload(Slot& s) { return reinterpret_cast<unsigned char*>(&s) + sizeof(Slot); }
+
+    std::string name_;
+    void* base_ = nullptr;
+    std::size_t size_ = 0;
+    Header* header_ = nullptr;
+};
+
+// ── Publisher ───────────────────────────────────────────────────────────────
+// Writes events into a segment. Any number of publishers, in any number of
+// processes, may share one. A full ring means the slowest subscriber is a
+// whole ring behind: Overflow::Block waits for it, Overflow::Fail returns
+// false. Either way, every 256th time a publisher finds the ring full it
+// first drops subscribers whose process has died. DropOldest would
+// overwrite a payload a subscriber may be reading and is rejected.
+//
+// A publisher that dies between claiming a slot and publishing it leaves a
+// hole. Each slot records who claimed it, and subscribers stuck on a hole
+// whose writer no longer exists skip it (see ShmSubscriber::skipped()).
+// Dying in the few instructions between the claim and that record, or the
+// pid being reused before a subscriber checks, still stalls subscribers at
+// the hole, and with them Overflow::Block publishers once the ring fills.
+// A publisher records the pid of the process that created it; do not use
+// one across fork().
+class ShmPublisher {
+public:
+    explicit ShmPublisher(ShmSegment& segment, Overflow overflow = Overflow::Block)
+        : segment_(segment),
+          header_(*segment.header_),
+          overflow_(overflow),
+          pid_(static_cast<std::int32_t>(getpid())) {
+        if (overflow == Overflow::DropOldest) {
+            throw std::invalid_argument("shared-memory publishers cannot drop events subscribers may be reading");
+        }
+    }
+
+    ~ShmPublisher() {
+#if defined(__QNXNTO__)
+        for (auto& c : connections_) {
+            if (c.coid >= 0) ConnectDetach(c.coid);
+        }
+#endif
+    }
+
+    ShmPublisher(const ShmPublisher&) = delete;
+    ShmPublisher& operator=(const ShmPublisher&) = delete;
+
+    // Claims a slot and calls fill(void* slot) to write `size` bytes (at
+    // most slot_size(), 16-byte aligned) straight into shared memory, then
+    // publishes them.
+    template <typename Fill>
+    bool publish_in_place(std::size_t size, Fill&& fill) {
+        if (size > segment_.slot_size()) throw std::length_error("event larger than the segment's slot size");
+        const std::uint64_t slots = header_.slots;
+        std::uint64_t sequence = header_.tail.load(std::memory_order_relaxed);
+        for (;;) {
+            if (sequence - gate_ >= slots) {
+                gate_ = oldest_cursor(sequence);
+                // A subscriber whose process died holds the ring forever;
+                // look for one every 256 times the ring is found full.
+                if (sequence - gate_ >= slots && ++full_ % 256 == 0 && drop_dead_subscribers()) {
+                    gate_ = oldest_cursor(sequence);
+                }
+                if (sequence - gate_ >= slots) {
+                    if (overflow_ == Overflow::Fail) return false;
+                    std::this_thread::yield();
+                    sequence = header_.tail.load(std::memory_order_relaxed);
+                    continue;
+                }
+            }
+            if (header_.tail.compare_exchange_weak(sequence, sequence + 1, std::memory_order_relaxed)) break;
+        }
+        ShmSegment::Slot& slot = segment_.slot(sequence);
+        slot.claim.store(ShmSegment::claim(sequence, pid_), std::memory_order_relaxed);
+        fill(static_cast<void*>(ShmSegment::payload(slot)));
+        slot.size = size;
+        slot.sequence.store(sequence + 1, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (header_.sleepers.load(std::memory_order_relaxed) != 0) wake_sleepers();
+        return true;
+    }
+
+    bool publish(const void* data, std::size_t size) {
+        return publish_in_place(size, [&](void* slot) { std::memcpy(slot, data, size); });
+    }
+
+    template <typename T>
+    bool publish(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "shared-memory events are copied as bytes");
+        return publish(&value, sizeof(T));
+    }
+
+private:
+    // Lowest cursor of the active subscribers; `tail` when there are none.
+    // The acquire pairs with the subscriber's release once it is done with
+    // a slot.
+    std::uint64_t oldest_cursor(std::uint64_t tail) const {
+        std::uint64_t oldest = tail;
+        for (auto& s : header_.subscribers) {
+            if (ShmSegment::phase(s.state.load()) != ShmSegment::kActive) continue;
+            std::uint64_t cursor = s.cursor.load(std::memory_order_acquire);
+            if (cursor < oldest) oldest = cursor;
+        }
+        return oldest;
+    }
+
+    // Frees the entries of active subscribers whose process has died;
+    // returns whether it freed any.
+    bool drop_dead_subscribers() {
+        bool dropped = false;
+        for (auto& s : header_.subscribers) {
+            std::uint64_t state = s.state.load();
+            std::int32_t pid = ShmSegment::owner(state);
+            if (ShmSegment::phase(state) != ShmSegment::kActive || pid <= 0) continue;
+            if (kill(pid, 0) == 0 || errno != ESRCH) continue;
+            std::uint64_t free = ShmSegment::state(0, ShmSegment::generation(state), ShmSegment::kFree);
+            dropped |= s.state.compare_exchange_strong(state, free);
+        }
+        return dropped;
+    }
+
+    void wake_sleepers() {
+        for (std::uint32_t i = 0; i < ShmSegment::kMaxSubscribers; ++i) {
+            auto& s = header_.subscribers[i];
+            if (s.sleeping.load(std::memory_order_relaxed) == 0) continue;
+#if defined(__linux__)
+            s.wake.fetch_add(1);
+            syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&s.wake), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#elif defined(__QNXNTO__)
+            auto& c = connections_[i];
+            std::int32_t pid = ShmSegment::owner(s.state.load(std::memory_order_relaxed));
+            if (c.coid < 0 || c.pid != pid || c.chid != s.chid) {
+                if (c.coid >= 0) ConnectDetach(c.coid);
+                c.pid = pid;
+                c.chid = s.chid;
+                c.coid = ConnectAttach(ND_LOCAL_NODE, pid, s.chid, _NTO_SIDE_CHANNEL, 0);
+            }
+            if (c.coid >= 0) MsgSendPulse(c.coid, -1, _PULSE_CODE_MINAVAIL, 0);
+#else
+            (void)i;  // subscribers poll
+#endif
+        }
+    }
+
+    ShmSegment& segment_;
+    ShmSegment::Header& header_;
+    Overflow overflow_;
+    std::int32_t pid_;
+    std::uint64_t gate_ = 0;  // a cursor no subscriber is behind
+    std::uint64_t full_ = 0;  // times the ring was found full
+#if defined(__QNXNTO__)
+    struct Connection {
+        std::int32_t pid = 0;
+        std::int32_t chid = -1;
+        int coid = -1;
+    };
+    Connection connections_[ShmSegment::kMaxSubscribers];
+#endif
+};
+
+// ── Subscriber ──────────────────────────────────────────────────────────────
+// Reads every event published after it joined, in publish order, straight
+// out of the segment. Throws std::length_error when the segment already has
+// kMaxSubscribers subscribers. A subscriber belongs to one thread.
+class ShmSubscriber {
+public:
+    explicit ShmSubscriber(ShmSegment& segment) : segment_(segment), header_(*segment.header_) {
+        const auto pid = static_cast<std::int32_t>(getpid());
+        for (auto& s : header_.subscribers) {
+            std::uint64_t state = s.state.load();
+            if (ShmSegment::phase(state) != ShmSegment::kFree) continue;
+            generation_ = ShmSegment::generation(state) + 1;
+            if (s.state.compare_exchange_strong(state, ShmSegment::state(pid, generation_, ShmSegment::kJoining))) {
+                self_ = &s;
+                break;
+            }
+        }
+        if (self_ == nullptr) throw std::length_error("too many subscribers on shared memory segment");
+#if defined(__QNXNTO__)
+        chid_ = ChannelCreate(0);
+        if (chid_ < 0) {
+            release();
+            throw std::runtime_error(std::string("ChannelCreate failed: ") + std::strerror(errno));
+        }
+#endif
+        self_->chid = chid_;
+        self_->sleeping.store(0);
+        // Publishers that have not seen this subscriber yet may overwrite
+        // slots up to a ring ahead of any tail they read before it became
+        // active; starting at the tail read after that is always safe.
+        self_->cursor.store(header_.tail.load());
+        self_->state.store(ShmSegment::state(pid, generation_, ShmSegment::kActive));
+        cursor_ = header_.tail.load();
+        self_->cursor.store(cursor_);
+    }
+
+    ~ShmSubscriber() {
+        release();
+#if defined(__QNXNTO__)
+        ChannelDestroy(chid_);
+#endif
+    }
+
+    ShmSubscriber(const ShmSubscriber&) = delete;
+    ShmSubscriber& operator=(const ShmSubscriber&) = delete;
+
+    // Calls handler(const void* data, std::size_t size) for up to `max`
+    // ready events and returns how many. `data` points into the segment and
+    // is valid only during the call.
+    template <typename Handler>
+    std::size_t poll(Handler&& handler, std::size_t max = std::numeric_limits<std::size_t>::max()) {
+        std::size_t n = 0;
+        while (n < max) {
+            ShmSegment::Slot& slot = segment_.slot(cursor_);
+            if (slot.sequence.load(std::memory_order_acquire) != cursor_ + 1) {
+                if (!abandoned(slot)) break;
+                ++skipped_;
+                self_->cursor.store(++cursor_, std::memory_order_release);
+                continue;
+            }
+            handler(static_cast<const void*>(ShmSegment::payload(slot)), static_cast<std::size_t>(slot.size));
+            ++cursor_;
+            // Hand slots back to publishers in batches, not per event.
+            if (++n % 32 == 0) self_->cursor.store(cursor_, std::memory_order_release);
+        }
+        if (n % 32 != 0) self_->cursor.store(cursor_, std::memory_order_release);
+        return n;
+    }
+
+    bool ready() const { return segment_.slot(cursor_).sequence.load(std::memory_order_acquire) == cursor_ + 1; }
+
+    // Blocks until an event is ready or `timeout` passes; returns ready().
+    // Yields a few times first, then sleeps on a futex (Linux) or receives
+    // a pulse (QNX); elsewhere it polls every 100 us.
+    bool wait(std::chrono::nanoseconds timeout) {
+        for (int spin = 0; spin < 16; ++spin) {
+            if (ready()) return true;
+            std::this_thread::yield();
+        }
+        header_.sleepers.fetch_add(1);
+        self_->sleeping.store(1);
+        std::uint32_t wake = self_->wake.load();
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ready()) sleep(wake, timeout);
+        self_->sleeping.store(0);
+        header_.sleepers.fetch_sub(1);
+        return ready();
+    }
+
+    // Events published but not yet read by this subscriber.
+    std::uint64_t backlog() const { return header_.tail.load(std::memory_order_relaxed) - cursor_; }
+
+    // Slots passed over because their publisher died before filling them.
+    std::uint64_t skipped() const { return skipped_; }
+
+private:
+    void release() { self_->state.store(ShmSegment::state(0, generation_, ShmSegment::kFree)); }
+
+    // Whether the unpublished slot at cursor_ was claimed by a process that
+    // has since died. A live writer is normally just a few stores away from
+    // publishing, so the kill() probe only runs once a poll has found the
+    // same slot unpublished 64 times in a row.
+    bool abandoned(ShmSegment::Slot& slot) {
+        if (header_.tail.load(std::memory_order_relaxed) <= cursor_) return false;
+        if (stalled_at_ != cursor_) {
+            stalled_at_ = cursor_;
+            stalled_polls_ = 0;
+        }
+        if (++stalled_polls_ % 64 != 0) return false;
+        std::uint64_t claim = slot.claim.load(std::memory_order_relaxed);
+        auto pid = static_cast<std::int32_t>(claim & 0xffffffffu);
+        if (claim != ShmSegment::claim(cursor_, pid) || pid <= 0) return false;  // not claimed for cursor_ yet
+        if (kill(pid, 0) == 0 || errno != ESRCH) return false;
+        // Dead writers store nothing more, but it may have published just
+        // before dying.
+        return slot.sequence.load(std::memory_order_acquire) != cursor_ + 1;
+    }
+
+    void sleep(std::uint32_t wake, std::chrono::nanoseconds timeout) {
+        auto ns = timeout.count();
+#if defined(__linux__)
+        timespec ts{static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&self_->wake), FUTEX_WAIT, wake, &ts, nullptr, 0);
+#elif defined(__QNXNTO__)
+        (void)wake;
+        std::uint64_t limit = static_cast<std::uint64_t>(ns);
+        TimerTimeout(CLOCK_MONOTONIC, _NTO_TIMEOUT_RECEIVE, nullptr, &limit, nullptr);
+        struct _pulse pulse;
+        MsgReceivePulse(chid_, &pulse, sizeof(pulse), nullptr);
+#else
+        (void)wake;
+        std::this_thread::sleep_for(std::min(timeout, std::chrono::nanoseconds(100000)));
+#endif
+    }
+
+    ShmSegment& segment_;
+    ShmSegment::Header& header_;
+    ShmSegment::Subscriber* self_ = nullptr;
+    std::uint64_t generation_ = 0;
+    std::uint64_t cursor_ = 0;
+    std::uint64_t skipped_ = 0;
+    std::uint64_t stalled_at_ = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t stalled_polls_ = 0;
+    int chid_ = -1;
+};
+
+}  // namespace events
+
+#endif  // SHM_EVENT_HPP
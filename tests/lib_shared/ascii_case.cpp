@@ -0,0 +1,138 @@
+// ASCII case conversion kernels
+//
+// Only 'a'-'z' / 'A'-'Z' change; every other byte, including UTF-8 lead
+// and continuation bytes, is copied through. That is what std::toupper /
+// std::tolower do in the "C" locale, without the per-byte call.
+#include "stringutils.h"
+#include <cstdint>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace stringutils {
+
+namespace {
+
+inline char flip_if(char c, char lo, char hi) {
+    return (c >= lo && c <= hi) ? static_cast<char>(c ^ 0x20) : c;
+}
+
+void scalar_convert(const char* in, char* out, std::size_t n, char lo, char hi) {
+    for (std::size_t i = 0; i < n; ++i) out[i] = flip_if(in[i], lo, hi);
+}
+
+#if defined(__x86_64__)
+// Signed-compare range test: adding (0x80 - lo) maps [lo, lo + 25] onto
+// [-128, -103], and no byte outside the range lands there.
+void sse2_convert(const char* in, char* out, std::size_t n, char lo, char hi) {
+    const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80 - lo));
+    const __m128i limit = _mm_set1_epi8(static_cast<char>(-128 + (hi - lo) + 1));
+    const __m128i flip = _mm_set1_epi8(0x20);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i in_range = _mm_cmplt_epi8(_mm_add_epi8(v, bias), limit);
+        v = _mm_xor_si128(v, _mm_and_si128(in_range, flip));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), v);
+    }
+    scalar_convert(in + i, out + i, n - i, lo, hi);
+}
+
+__attribute__((target("avx2")))
+void avx2_convert(const char* in, char* out, std::size_t n, char lo, char hi) {
+    const __m256i bias = _mm256_set1_epi8(static_cast<char>(0x80 - lo));
+    const __m256i limit = _mm256_set1_epi8(static_cast<char>(-128 + (hi - lo) + 1));
+    const __m256i flip = _mm256_set1_epi8(0x20);
+    std::size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 32));
+        __m256i r0 = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(v0, bias));
+        __m256i r1 = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(v1, bias));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_xor_si256(v0, _mm256_and_si256(r0, flip)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + 32), _mm256_xor_si256(v1, _mm256_and_si256(r1, flip)));
+    }
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i r = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(v, bias));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_xor_si256(v, _mm256_and_si256(r, flip)));
+    }
+    // Finish here rather than handing off to the SSE2 kernel: jumping to
+    // legacy-SSE code with dirty upper YMM state costs more than the tail.
+    const __m128i bias16 = _mm256_castsi256_si128(bias);
+    const __m128i limit16 = _mm256_castsi256_si128(limit);
+    const __m128i flip16 = _mm256_castsi256_si128(flip);
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i r = _mm_cmplt_epi8(_mm_add_epi8(v, bias16), limit16);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_xor_si128(v, _mm_and_si128(r, flip16)));
+    }
+    for (; i < n; ++i) out[i] = flip_if(in[i], lo, hi);
+    _mm256_zeroupper();
+}
+
+using ConvertFn = void (*)(const char*, char*, std::size_t, char, char);
+
+ConvertFn select_convert() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? avx2_convert : sse2_convert;
+}
+
+void convert(const char* in, char* out, std::size_t n, char lo, char hi) {
+    static const ConvertFn fn = select_convert();
+    fn(in, out, n, lo, hi);
+}
+#elif defined(__aarch64__)
+void convert(const char* in, char* out, std::size_t n, char lo, char hi) {
+    const uint8x16_t base = vdupq_n_u8(static_cast<std::uint8_t>(lo));
+    const uint8x16_t span = vdupq_n_u8(static_cast<std::uint8_t>(hi - lo));
+    const uint8x16_t flip = vdupq_n_u8(0x20);
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        uint8x16_t v0 = vld1q_u8(reinterpret_cast<const std::uint8_t*>(in + i));
+        uint8x16_t v1 = vld1q_u8(reinterpret_cast<const std::uint8_t*>(in + i + 16));
+        // Unsigned (c - lo) <= (hi - lo) selects exactly the letter range.
+        uint8x16_t r0 = vcleq_u8(vsubq_u8(v0, base), span);
+        uint8x16_t r1 = vcleq_u8(vsubq_u8(v1, base), span);
+        vst1q_u8(reinterpret_cast<std::uint8_t*>(out + i), veorq_u8(v0, vandq_u8(r0, flip)));
+        vst1q_u8(reinterpret_cast<std::uint8_t*>(out + i + 16), veorq_u8(v1, vandq_u8(r1, flip)));
+    }
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t v = vld1q_u8(reinterpret_cast<const std::uint8_t*>(in + i));
+        uint8x16_t r = vcleq_u8(vsubq_u8(v, base), span);
+        vst1q_u8(reinterpret_cast<std::uint8_t*>(out + i), veorq_u8(v, vandq_u8(r, flip)));
+    }
+    scalar_convert(in + i, out + i, n - i, lo, hi);
+}
+#else
+void convert(const char* in, char* out, std::size_t n, char lo, char hi) {
+    scalar_convert(in, out, n, lo, hi);
+}
+#endif
+
+}  // namespace
+
+std::string to_upper(const std::string& s) {
+    std::string result(s.size(), '\0');
+    convert(s.data(), &result[0], s.size(), 'a', 'z');
+    return result;
+}
+
+std::string to_lower(const std::string& s) {
+    std::string result(s.size(), '\0');
+    convert(s.data(), &result[0], s.size(), 'A', 'Z');
+    return result;
+}
+
+void to_upper(std::string_view in, char* out) { convert(in.data(), out, in.size(), 'a', 'z'); }
+void to_lower(std::string_view in, char* out) { convert(in.data(), out, in.size(), 'A', 'Z'); }
+
+void to_upper_inplace(char* s, std::size_t n) { convert(s, s, n, 'a', 'z'); }
+void to_lower_inplace(char* s, std::size_t n) { convert(s, s, n, 'A', 'Z'); }
+void to_upper_inplace(std::string& s) { convert(s.data(), s.data(), s.size(), 'a', 'z'); }
+void to_lower_inplace(std::string& s) { convert(s.data(), s.data(), s.size(), 'A', 'Z'); }
+
+}  // namespace stringutils
@@ -0,0 +1,484 @@
+// CSV parsing
+//
+// Each 64-byte block is classified into three bitmasks: delimiters and
+// newlines, quotes, and escape characters. Escaped positions are cleared
+// from the other two, then a prefix XOR of the quote bits marks every byte
+// inside quotes (an opening quote flips the parity on, the closing one
+// back off, and a doubled "" inside a field flips it twice). What is left
+// of the structural mask are the real field ends, visited with ctz.
+//
+// Fields only need a closer look when a quote or escape character lies
+// inside them, which the parser knows from the position of the last such
+// character, so plain fields cost nothing beyond the mask walk.
+#include "csv.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace stringutils {
+
+const char* csv_error_name(CsvError e) noexcept {
+    switch (e) {
+        case CsvError::None:              return "none";
+        case CsvError::UnterminatedQuote: return "unterminated quote";
+        case CsvError::TextAfterQuote:    return "text after closing quote";
+        case CsvError::StrayQuote:        return "quote in unquoted field";
+    }
+    return "unknown";
+}
+
+namespace {
+
+struct BlockMasks {
+    std::uint64_t structural;  // delimiter or '\n'
+    std::uint64_t quote;
+    std::uint64_t escape;
+};
+
+#if defined(__x86_64__)
+inline std::uint64_t sse2_eq(const __m128i v[4], __m128i c) {
+    std::uint64_t m = 0;
+    for (int k = 0; k < 4; ++k) {
+        m |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v[k], c))))
+             << (16 * k);
+    }
+    return m;
+}
+
+void sse2_classify(const char* p, const CsvDialect& d, BlockMasks& m) {
+    __m128i v[4];
+    for (int k = 0; k < 4; ++k) v[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * k));
+    m.structural = sse2_eq(v, _mm_set1_epi8(d.delimiter)) | sse2_eq(v, _mm_set1_epi8('\n'));
+    m.quote = sse2_eq(v, _mm_set1_epi8(d.quote));
+    m.escape = sse2_eq(v, _mm_set1_epi8(d.escape));
+}
+
+__attribute__((target("avx2")))
+inline std::uint64_t avx2_eq(__m256i lo, __m256i hi, __m256i c) {
+    auto l = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, c)));
+    auto h = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, c)));
+    return static_cast<std::uint64_t>(h) << 32 | l;
+}
+
+__attribute__((target("avx2")))
+void avx2_classify(const char* p, const CsvDialect& d, BlockMasks& m) {
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+    m.structural = avx2_eq(lo, hi, _mm256_set1_epi8(d.delimiter)) | avx2_eq(lo, hi, _mm256_set1_epi8('\n'));
+    m.quote = avx2_eq(lo, hi, _mm256_set1_epi8(d.quote));
+    m.escape = avx2_eq(lo, hi, _mm256_set1_epi8(d.escape));
+}
+
+using ClassifyFn = void (*)(const char*, const CsvDialect&, BlockMasks&);
+
+ClassifyFn select_classify() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? avx2_classify : sse2_classify;
+}
+
+inline void classify(const char* p, const CsvDialect& d, BlockMasks& m) {
+    static const ClassifyFn fn = select_classify();
+    fn(p, d, m);
+}
+#elif defined(__aarch64__)
+// No movemask on NEON: weight each lane by its bit and add pairwise down
+// to eight bytes.
+inline std::uint64_t neon_eq(const uint8x16_t v[4], uint8_t c) {
+    static const uint8_t kWeights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    const uint8x16_t weights = vld1q_u8(kWeights);
+    const uint8x16_t needle = vdupq_n_u8(c);
+    uint8x16_t t0 = vandq_u8(vceqq_u8(v[0], needle), weights);
+    uint8x16_t t1 = vandq_u8(vceqq_u8(v[1], needle), weights);
+    uint8x16_t t2 = vandq_u8(vceqq_u8(v[2], needle), weights);
+    uint8x16_t t3 = vandq_u8(vceqq_u8(v[3], needle), weights);
+    uint8x16_t sum = vpaddq_u8(vpaddq_u8(t0, t1), vpaddq_u8(t2, t3));
+    sum = vpaddq_u8(sum, sum);
+    return vgetq_lane_u64(vreinterpretq_u64_u8(sum), 0);
+}
+
+inline void classify(const char* p, const CsvDialect& d, BlockMasks& m) {
+    const auto* u = reinterpret_cast<const std::uint8_t*>(p);
+    uint8x16_t v[4] = {vld1q_u8(u), vld1q_u8(u + 16), vld1q_u8(u + 32), vld1q_u8(u + 48)};
+    m.structural = neon_eq(v, static_cast<uint8_t>(d.delimiter)) | neon_eq(v, '\n');
+    m.quote = neon_eq(v, static_cast<uint8_t>(d.quote));
+    m.escape = neon_eq(v, static_cast<uint8_t>(d.escape));
+}
+#else
+inline void classify(const char* p, const CsvDialect& d, BlockMasks& m) {
+    m = {0, 0, 0};
+    for (unsigned i = 0; i < 64; ++i) {
+        std::uint64_t bit = std::uint64_t{1} << i;
+        if (p[i] == d.delimiter || p[i] == '\n') m.structural |= bit;
+        if (p[i] == d.quote) m.quote |= bit;
+        if (p[i] == d.escape) m.escape |= bit;
+    }
+}
+#endif
+
+// Bit i set when an odd number of bits at or below i are set in x.
+inline std::uint64_t prefix_xor(std::uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+// Positions made literal by a preceding live escape character. An escape
+// that is itself escaped is not live. `carry` is 1 when bit 0 is escaped
+// from the previous block and is updated for the next one.
+inline std::uint64_t escaped_positions(std::uint64_t escape, std::uint64_t& carry) {
+    std::uint64_t escaped = carry;
+    carry = 0;
+    for (std::uint64_t rest = escape; rest != 0; rest &= rest - 1) {
+        auto i = static_cast<unsigned>(__builtin_ctzll(rest));
+        if ((escaped >> i) & 1) continue;
+        if (i == 63) {
+            carry = 1;
+        } else {
+            escaped |= std::uint64_t{1} << (i + 1);
+        }
+    }
+    return escaped;
+}
+
+// Loads the 64-byte block at `offset`, zero-padding a short tail, and
+// returns the masks restricted to real input with escapes applied.
+inline BlockMasks block_masks(std::string_view data, std::size_t offset, const CsvDialect& d,
+                              std::uint64_t& escape_carry) {
+    const char* p = data.data() + offset;
+    std::size_t n = std::min<std::size_t>(64, data.size() - offset);
+    char tail[64];
+    if (n < 64) {
+        std::memcpy(tail, p, n);
+        std::memset(tail + n, 0, sizeof(tail) - n);
+        p = tail;
+    }
+    BlockMasks m;
+    classify(p, d, m);
+    const std::uint64_t valid = n == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << n) - 1;
+    m.structural &= valid;
+    m.quote = d.quote ? m.quote & valid : 0;
+    m.escape = d.escape ? m.escape & valid : 0;
+    if ((m.escape | escape_carry) != 0) {
+        std::uint64_t escaped = escaped_positions(m.escape, escape_carry);
+        m.structural &= ~escaped;
+        m.quote &= ~escaped;
+    }
+    return m;
+}
+
+}  // namespace
+
+// ── CsvRecord ───────────────────────────────────────────────────────────────
+std::string_view CsvRecord::unescaped(std::size_t i, std::string& scratch) const {
+    if (!needs_unescape(i)) return fields_[i];
+    std::string_view f = fields_[i];
+    scratch.clear();
+    scratch.reserve(f.size());
+    for (std::size_t k = 0; k < f.size(); ++k) {
+        char c = f[k];
+        if (dialect_.escape && c == dialect_.escape && k + 1 < f.size()) {
+            c = f[++k];
+        } else if (dialect_.quote && c == dialect_.quote && k + 1 < f.size() && f[k + 1] == dialect_.quote) {
+            ++k;
+        }
+        scratch += c;
+    }
+    return scratch;
+}
+
+// ── CsvParser ───────────────────────────────────────────────────────────────
+CsvParser::CsvParser(std::string_view data, const CsvDialect& dialect, bool last_chunk, std::size_t base_offset)
+    : data_(data), dialect_(dialect), last_chunk_(last_chunk), base_(base_offset) {}
+
+bool CsvParser::load_block() {
+    if (block_loaded_) {
+        if (special_ != 0) last_special_ = static_cast<std::int64_t>(block_ + 63 - __builtin_clzll(special_));
+        block_ += 64;
+    }
+    block_loaded_ = block_ < data_.size();
+    if (!block_loaded_) return false;
+
+    BlockMasks m = block_masks(data_, block_, dialect_, escape_carry_);
+    std::uint64_t inside = prefix_xor(m.quote) ^ in_quote_;
+    in_quote_ = static_cast<std::uint64_t>(static_cast<std::int64_t>(inside) >> 63);
+    structural_ = m.structural & ~inside;
+    special_ = m.quote | m.escape;
+    return true;
+}
+
+bool CsvParser::fail(CsvError e) {
+    error_ = e;
+    error_offset_ = record_start_;
+    return false;
+}
+
+// `last_special` is the offset of the last quote or escape character
+// before `end`, or -1.
+bool CsvParser::push_field(CsvRecord& record, std::size_t start, std::size_t end, std::int64_t last_special) {
+    std::string_view f(data_.data() + start, end - start);
+    bool escaped = false;
+    if (static_cast<std::int64_t>(start) <= last_special) {
+        const char quote = dialect_.quote;
+        const char escape = dialect_.escape;
+        bool quoted = quote && f[0] == quote;
+        if (quoted) {
+            if (f.size() < 2 || f.back() != quote) return fail(CsvError::TextAfterQuote);
+            f = f.substr(1, f.size() - 2);
+        }
+        for (std::size_t i = 0; i < f.size(); ++i) {
+            if (escape && f[i] == escape) {
+                escaped = true;
+                ++i;
+            } else if (quote && f[i] == quote) {
+                if (!quoted) return fail(CsvError::StrayQuote);
+                if (i + 1 == f.size() || f[i + 1] != quote) return fail(CsvError::TextAfterQuote);
+                escaped = true;
+                ++i;
+            }
+        }
+    }
+    record.fields_.push_back(f);
+    record.escaped_.push_back(escaped);
+    record.any_escaped_ |= escaped;
+    return true;
+}
+
+bool CsvParser::next(CsvRecord& record) {
+    record.clear();
+    record.dialect_ = dialect_;
+    if (error_ != CsvError::None) return false;
+    for (;;) {
+        while (structural_ == 0) {
+            if (!load_block()) return finish(record);
+        }
+        auto bit = static_cast<unsigned>(__builtin_ctzll(structural_));
+        structural_ &= structural_ - 1;
+        const std::size_t pos = block_ + bit;
+        const std::uint64_t below = special_ & ((std::uint64_t{1} << bit) - 1);
+        const std::int64_t last_special =
+            below != 0 ? static_cast<std::int64_t>(block_ + 63 - __builtin_clzll(below)) : last_special_;
+
+        if (data_[pos] != '\n') {
+            if (!push_field(record, field_start_, pos, last_special)) return false;
+            field_start_ = pos + 1;
+            continue;
+        }
+        std::size_t end = pos;
+        if (end > field_start_ && data_[end - 1] == '\r') --end;
+        if (record.empty() && end == field_start_) {
+            record_start_ = field_start_ = pos + 1;  // blank line
+            continue;
+        }
+        record.offset_ = base_ + record_start_;
+        if (!push_field(record, field_start_, end, last_special)) return false;
+        record_start_ = field_start_ = pos + 1;
+        return true;
+    }
+}
+
+// Input exhausted: emit an unterminated last record if the input is
+// complete, otherwise leave it for the next chunk.
+bool CsvParser::finish(CsvRecord& record) {
+    if (in_quote_ != 0) return last_chunk_ ? fail(CsvError::UnterminatedQuote) : false;
+    std::size_t end = data_.size();
+    if (end > field_start_ && data_[end - 1] == '\r') --end;
+    if (record.empty() && end == field_start_) {
+        record_start_ = field_start_ = data_.size();
+        return false;
+    }
+    if (!last_chunk_) return false;
+    record.offset_ = base_ + record_start_;
+    if (!push_field(record, field_start_, end, last_special_)) return false;
+    record_start_ = field_start_ = data_.size();
+    return true;
+}
+
+// ── MappedFile ──────────────────────────────────────────────────────────────
+namespace {
+
+std::runtime_error sys_error(const char* what, const std::string& path) {
+    return std::runtime_error(std::string(what) + " " + path + ": " + std::strerror(errno));
+}
+
+}  // namespace
+
+MappedFile::MappedFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw sys_error("cannot open", path);
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw sys_error("cannot stat", path);
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (size_ > 0) {
+        void* p = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            throw sys_error("cannot mmap", path);
+        }
+        data_ = static_cast<char*>(p);
+        posix_madvise(data_, size_, POSIX_MADV_SEQUENTIAL);
+    }
+    // The mapping keeps its own reference to the file.
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data_) munmap(data_, size_);
+}
+
+// ── CsvReader ───────────────────────────────────────────────────────────────
+CsvReader::CsvReader(const std::string& path, const CsvDialect& dialect, std::size_t buffer_size)
+    : dialect_(dialect), buffer_(std::max<std::size_t>(buffer_size, 64)), parser_({}, dialect, false) {
+    fd_ = open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) throw sys_error("cannot open", path);
+}
+
+CsvReader::~CsvReader() {
+    if (fd_ >= 0) close(fd_);
+}
+
+bool CsvReader::next(CsvRecord& record) {
+    for (;;) {
+        if (parser_.next(record)) return true;
+        if (parser_.error() != CsvError::None || eof_) return false;
+        refill();
+    }
+}
+
+// Keeps the unfinished record, reads behind it and restarts the parser at
+// its start. A record that fills the whole buffer doubles it.
+void CsvReader::refill() {
+    const std::size_t keep_from = parser_.position() - base_;
+    const std::size_t keep = filled_ - keep_from;
+    std::memmove(buffer_.data(), buffer_.data() + keep_from, keep);
+    base_ += keep_from;
+    filled_ = keep;
+    if (filled_ == buffer_.size()) buffer_.resize(buffer_.size() * 2);
+
+    ssize_t n;
+    do {
+        n = read(fd_, buffer_.data() + filled_, buffer_.size() - filled_);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) throw std::runtime_error(std::string("cannot read CSV input: ") + std::strerror(errno));
+    if (n == 0) eof_ = true;
+    filled_ += static_cast<std::size_t>(n);
+    parser_ = CsvParser({buffer_.data(), filled_}, dialect_, eof_, base_);
+}
+
+// ── Parallel parsing ────────────────────────────────────────────────────────
+namespace {
+
+// Quote characters that toggle quoting in `s`, which must not start on an
+// escaped character.
+std::size_t count_quotes(std::string_view s, const CsvDialect& d) {
+    if (!d.quote) return 0;
+    std::size_t count = 0;
+    std::uint64_t carry = 0;
+    for (std::size_t offset = 0; offset < s.size(); offset += 64) {
+        count += static_cast<std::size_t>(__builtin_popcountll(block_masks(s, offset, d, carry).quote));
+    }
+    return count;
+}
+
+// Offset just past the first record-ending newline at or after `from`,
+// given whether `from` lies inside quotes.
+std::size_t next_record(std::string_view data, std::size_t from, bool in_quote, const CsvDialect& d) {
+    for (std::size_t i = from; i < data.size(); ++i) {
+        char c = data[i];
+        if (d.escape && c == d.escape) {
+            ++i;
+        } else if (d.quote && c == d.quote) {
+            in_quote = !in_quote;
+        } else if (c == '\n' && !in_quote) {
+            return i + 1;
+        }
+    }
+    return data.size();
+}
+
+// Below this many bytes per thread, starting threads costs more than it saves.
+constexpr std::size_t kMinChunk = 64 * 1024;
+
+template <typename Fn>
+void run_chunks(std::size_t chunks, Fn&& fn) {
+    std::vector<std::thread> workers;
+    workers.reserve(chunks - 1);
+    for (std::size_t i = 1; i < chunks; ++i) workers.emplace_back(fn, i);
+    fn(0);
+    for (auto& t : workers) t.join();
+}
+
+}  // namespace
+
+CsvStatus parse_csv_parallel(std::string_view data, unsigned threads,
+                             const std::function<void(std::size_t, const CsvRecord&)>& fn,
+                             const CsvDialect& dialect) {
+    std::size_t chunks = std::max<std::size_t>(1, std::min<std::size_t>(threads, data.size() / kMinChunk));
+
+    // Equal cuts, each moved off any escaped character.
+    std::vector<std::size_t> cut(chunks + 1);
+    for (std::size_t i = 1; i < chunks; ++i) {
+        std::size_t c = std::max(cut[i - 1], data.size() / chunks * i);
+        while (dialect.escape && c > 0 && c < data.size() && data[c - 1] == dialect.escape) ++c;
+        cut[i] = c;
+    }
+    cut[chunks] = data.size();
+
+    std::vector<std::size_t> quotes(chunks);
+    if (chunks > 1) {
+        run_chunks(chunks - 1, [&](std::size_t i) {
+            quotes[i] = count_quotes(data.substr(cut[i], cut[i + 1] - cut[i]), dialect);
+        });
+    }
+
+    std::vector<std::size_t> start(chunks + 1);
+    bool in_quote = false;
+    for (std::size_t i = 1; i < chunks; ++i) {
+        in_quote ^= (quotes[i - 1] & 1) != 0;
+        start[i] = std::max(start[i - 1], next_record(data, cut[i], in_quote, dialect));
+    }
+    start[chunks] = data.size();
+
+    std::vector<CsvStatus> status(chunks);
+    run_chunks(chunks, [&](std::size_t i) {
+        CsvParser parser(data.substr(start[i], start[i + 1] - start[i]), dialect, true, start[i]);
+        CsvRecord record;
+        while (parser.next(record)) {
+            fn(i, record);
+            ++status[i].records;
+        }
+        status[i].error = parser.error();
+        status[i].error_offset = parser.error_offset();
+    });
+
+    CsvStatus total;
+    for (const CsvStatus& s : status) {
+        total.records += s.records;
+        if (!s.ok()) {
+            total.error = s.error;
+            total.error_offset = s.error_offset;
+            break;
+        }
+    }
+    return total;
+}
+
+}  // namespace stringutils
@@ -0,0 +1,189 @@
+// Shared library: streaming CSV / delimited-record parsing
+#ifndef CSV_H
+#define CSV_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace stringutils {
+
+// RFC 4180 by default: ',' separated, '"' quoted, a quote inside a quoted
+// field written twice. Setting `escape` (typically '\\') additionally makes
+// the following character literal, inside or outside quotes. '\0' turns
+// quoting or escaping off. Records end at "\n" or "\r\n"; blank lines are
+// skipped.
+struct CsvDialect {
+    char delimiter = ',';
+    char quote = '"';
+    char escape = '\0';
+};
+
+enum class CsvError {
+    None,
+    UnterminatedQuote,  // input ended inside a quoted field
+    TextAfterQuote,     // "abc"def
+    StrayQuote,         // ab"c": quote inside an unquoted field
+};
+
+const char* csv_error_name(CsvError e) noexcept;
+
+// One record. Fields are views into the parser's input; quoted fields are
+// stored without their enclosing quotes. A field containing doubled quotes
+// or escapes is left raw and flagged; unescaped() decodes it.
+class CsvRecord {
+public:
+    std::size_t size() const { return fields_.size(); }
+    bool empty() const { return fields_.empty(); }
+    std::string_view operator[](std::size_t i) const { return fields_[i]; }
+    const std::vector<std::string_view>& fields() const { return fields_; }
+    std::vector<std::string_view>::const_iterator begin() const { return fields_.begin(); }
+    std::vector<std::string_view>::const_iterator end() const { return fields_.end(); }
+
+    bool needs_unescape(std::size_t i) const { return any_escaped_ && escaped_[i] != 0; }
+    // The decoded field: fields_[i] itself when nothing needs decoding,
+    // otherwise a view of `scratch`, which is overwritten.
+    std::string_view unescaped(std::size_t i, std::string& scratch) const;
+
+    // Byte offset of the record in the parsed input.
+    std::size_t offset() const { return offset_; }
+
+private:
+    friend class CsvParser;
+
+    void clear() {
+        fields_.clear();
+        escaped_.clear();
+        any_escaped_ = false;
+    }
+
+    std::vector<std::string_view> fields_;
+    std::vector<std::uint8_t> escaped_;
+    bool any_escaped_ = false;
+    std::size_t offset_ = 0;
+    CsvDialect dialect_;
+};
+
+// Pull parser over a buffer that outlives it. Delimiters and newlines are
+// located 64 bytes at a time as bitmasks (AVX2/SSE2 on x86, NEON on
+// aarch64); quoted regions are masked out with a prefix XOR of the quote
+// bits, so the per-field work is a count-trailing-zeros and a push_back.
+//
+// With last_chunk = false the input is a prefix of a longer stream: a
+// record not yet terminated by a newline is not returned, next() returns
+// false with error() == None and position() marks where it starts.
+// base_offset is added to every reported offset, for input that is a
+// slice of a larger file.
+class CsvParser {
+public:
+    explicit CsvParser(std::string_view data, const CsvDialect& dialect = {}, bool last_chunk = true,
+                       std::size_t base_offset = 0);
+
+    // Fills `record` with the next record. Returns false at the end of the
+    // input or on a malformed record (see error()); parsing stops there.
+    bool next(CsvRecord& record);
+
+    CsvError error() const { return error_; }
+    // Offset of the record that failed to parse.
+    std::size_t error_offset() const { return base_ + error_offset_; }
+    // Start of the first record not yet returned.
+    std::size_t position() const { return base_ + record_start_; }
+
+private:
+    bool load_block();
+    bool push_field(CsvRecord& record, std::size_t start, std::size_t end, std::int64_t last_special);
+    bool finish(CsvRecord& record);
+    bool fail(CsvError e);
+
+    std::string_view data_;
+    CsvDialect dialect_;
+    bool last_chunk_;
+    std::size_t base_;
+
+    std::size_t block_ = 0;            // offset of the current 64-byte block
+    bool block_loaded_ = false;
+    std::uint64_t structural_ = 0;     // unvisited delimiters/newlines outside quotes
+    std::uint64_t special_ = 0;        // quote and escape characters in the block
+    std::uint64_t in_quote_ = 0;       // all ones when the previous block ended inside quotes
+    std::uint64_t escape_carry_ = 0;   // 1 when the previous block ended with a live escape
+    std::int64_t last_special_ = -1;   // last special character before the current block
+
+    std::size_t record_start_ = 0;
+    std::size_t field_start_ = 0;
+    CsvError error_ = CsvError::None;
+    std::size_t error_offset_ = 0;
+};
+
+// Read-only mmap of a whole file. Throws std::runtime_error (with errno
+// text) when the file cannot be opened or mapped. A trimmed counterpart of
+// mathlib::MappedFile in lib_static: libstringutils.so is built and linked
+// on its own, so it does not take a dependency on the static library.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view view() const { return {data_, size_}; }
+
+private:
+    char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// Streams a file through a fixed buffer with read(2), so memory stays at
+// the buffer size (grown only for a record longer than it). Record views
+// are valid until the next call to next(). Throws std::runtime_error when
+// the file cannot be opened or read.
+class CsvReader {
+public:
+    explicit CsvReader(const std::string& path, const CsvDialect& dialect = {}, std::size_t buffer_size = 1 << 20);
+    ~CsvReader();
+    CsvReader(const CsvReader&) = delete;
+    CsvReader& operator=(const CsvReader&) = delete;
+
+    // Record offsets are file offsets.
+    bool next(CsvRecord& record);
+
+    CsvError error() const { return parser_.error(); }
+    std::size_t error_offset() const { return parser_.error_offset(); }
+
+private:
+    void refill();
+
+    int fd_ = -1;
+    CsvDialect dialect_;
+    std::vector<char> buffer_;
+    std::size_t filled_ = 0;
+    std::size_t base_ = 0;  // file offset of buffer_[0]
+    bool eof_ = false;
+    CsvParser parser_;
+};
+
+struct CsvStatus {
+    std::size_t records = 0;
+    CsvError error = CsvError::None;
+    std::size_t error_offset = 0;
+
+    bool ok() const { return error == CsvError::None; }
+};
+
+// Parses `data` on up to `threads` threads. The input is cut into equal
+// ranges; one pass counts unescaped quotes per range so each cut knows
+// whether it lies inside a quoted field, then each cut moves forward to the
+// next record boundary. fn(chunk, record) is called concurrently from
+// different chunks, in order within a chunk; chunks are in input order, so
+// results collected per chunk concatenate to the sequential order. Parsing
+// of a chunk stops at its first malformed record; the status reports the
+// earliest one.
+CsvStatus parse_csv_parallel(std::string_view data, unsigned threads,
+                             const std::function<void(std::size_t, const CsvRecord&)>& fn,
+                             const CsvDialect& dialect = {});
+
+}  // namespace stringutils
+
+#endif  // CSV_H
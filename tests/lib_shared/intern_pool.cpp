@@ -0,0 +1,130 @@
+// String interning implementation
+#include "intern_pool.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace stringutils {
+
+namespace {
+
+inline std::uint64_t load64(const char* p) {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline std::uint64_t mix(std::uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// One multiply per eight bytes and a full avalanche at the end; keys are
+// short, so this beats both a byte-wise FNV and std::hash.
+std::uint64_t hash_bytes(std::string_view s) {
+    const char* p = s.data();
+    std::size_t n = s.size();
+    std::uint64_t h = 0x9e3779b97f4a7c15ULL ^ n;
+    for (; n >= 8; p += 8, n -= 8) {
+        h = (h ^ load64(p)) * 0x9fb21c651e98df25ULL;
+        h ^= h >> 29;
+    }
+    std::uint64_t tail = 0;
+    if (n != 0) std::memcpy(&tail, p, n);  // p may be null for an empty view
+    return mix(h ^ tail);
+}
+
+}  // namespace
+
+InternPool::Table::Table(std::size_t capacity)
+    : mask(capacity - 1), slots(new std::atomic<const Entry*>[capacity]) {
+    for (std::size_t i = 0; i < capacity; ++i) slots[i].store(nullptr, std::memory_order_relaxed);
+}
+
+InternPool::InternPool() {
+    tables_.push_back(std::make_unique<Table>(1024));
+    table_.store(tables_.back().get(), std::memory_order_release);
+}
+
+InternPool::~InternPool() = default;
+
+const InternPool::Entry* InternPool::lookup(const Table& table, std::uint64_t hash, std::string_view s) const {
+    for (std::size_t i = hash & table.mask;; i = (i + 1) & table.mask) {
+        const Entry* e = table.slots[i].load(std::memory_order_acquire);
+        if (e == nullptr) return nullptr;
+        if (e->hash == hash && e->length == s.size() && std::memcmp(e->chars(), s.data(), s.size()) == 0) {
+            return e;
+        }
+    }
+}
+
+InternPool::Id InternPool::find(std::string_view s) const {
+    const Entry* e = lookup(*table_.load(std::memory_order_acquire), hash_bytes(s), s);
+    return e ? e->id : kNotFound;
+}
+
+InternPool::Id InternPool::intern(std::string_view s) {
+    const std::uint64_t hash = hash_bytes(s);
+    if (const Entry* e = lookup(*table_.load(std::memory_order_acquire), hash, s)) return e->id;
+
+    std::lock_guard<std::mutex> lock(insert_mutex_);
+    // Another thread may have inserted it, or grown the table, meanwhile.
+    if (const Entry* e = lookup(*tables_.back(), hash, s)) return e->id;
+
+    const std::size_t count = size_.load(std::memory_order_relaxed);
+    std::size_t offset;
+    std::size_t chunk = chunk_of(static_cast<Id>(count), offset);
+    if (count >= kNotFound || chunk >= kMaxChunks) throw std::length_error("intern pool full");
+    if (s.size() > UINT32_MAX) throw std::length_error("interned string too long");
+    if ((count + 1) * 2 > tables_.back()->mask + 1) grow();
+
+    const std::size_t bytes = sizeof(Entry) + s.size() + 1;
+    auto* e = reinterpret_cast<Entry*>(arena_.allocate(bytes, alignof(Entry)));
+    e->hash = hash;
+    e->length = static_cast<std::uint32_t>(s.size());
+    e->id = static_cast<Id>(count);
+    char* chars = reinterpret_cast<char*>(e + 1);
+    if (!s.empty()) std::memcpy(chars, s.data(), s.size());
+    chars[s.size()] = '\0';
+    arena_bytes_ += bytes;
+
+    if (!chunks_[chunk]) chunks_[chunk].reset(new const Entry*[kFirstChunk << chunk]);
+    chunks_[chunk][offset] = e;
+
+    // Publishing the slot releases the entry and its index entry together.
+    Table& table = *tables_.back();
+    std::size_t i = hash & table.mask;
+    while (table.slots[i].load(std::memory_order_relaxed) != nullptr) i = (i + 1) & table.mask;
+    table.slots[i].store(e, std::memory_order_release);
+    size_.store(count + 1, std::memory_order_release);
+    return e->id;
+}
+
+void InternPool::grow() {
+    const Table& old = *tables_.back();
+    auto bigger = std::make_unique<Table>((old.mask + 1) * 2);
+    for (std::size_t i = 0; i <= old.mask; ++i) {
+        const Entry* e = old.slots[i].load(std::memory_order_relaxed);
+        if (e == nullptr) continue;
+        std::size_t j = e->hash & bigger->mask;
+        while (bigger->slots[j].load(std::memory_order_relaxed) != nullptr) j = (j + 1) & bigger->mask;
+        bigger->slots[j].store(e, std::memory_order_relaxed);
+    }
+    table_.store(bigger.get(), std::memory_order_release);
+    tables_.push_back(std::move(bigger));
+}
+
+std::size_t InternPool::memory_bytes() const {
+    std::lock_guard<std::mutex> lock(insert_mutex_);
+    std::size_t bytes = arena_bytes_;
+    for (const auto& t : tables_) bytes += (t->mask + 1) * sizeof(std::atomic<const Entry*>);
+    for (std::size_t c = 0; c < kMaxChunks; ++c) {
+        if (chunks_[c]) bytes += (kFirstChunk << c) * sizeof(const Entry*);
+    }
+    return bytes;
+}
+
+}  // namespace stringutils
@@ -0,0 +1,98 @@
+// Shared library: thread-safe string interning
+#ifndef INTERN_POOL_H
+#define INTERN_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+#include "string_builder.h"
+
+namespace stringutils {
+
+// Maps strings to dense 32-bit IDs (0, 1, 2, ... in insertion order) and
+// back. Each distinct string is stored once, NUL-terminated, in an arena
+// and never moves or is freed before the pool, so views and c_str()
+// pointers stay valid for the pool's lifetime.
+//
+// find() and the lookup half of intern() are lock-free: they probe an
+// open-addressing table through acquire loads. Only inserting a new string
+// takes the mutex. Tables replaced by growth are kept until the pool is
+// destroyed, so a reader never touches freed memory; together they cost
+// less than the current table.
+//
+// view()/c_str() are O(1) array lookups. An ID must come from this pool.
+class InternPool {
+public:
+    using Id = std::uint32_t;
+    static constexpr Id kNotFound = static_cast<Id>(-1);
+
+    InternPool();
+    ~InternPool();
+    InternPool(const InternPool&) = delete;
+    InternPool& operator=(const InternPool&) = delete;
+
+    Id intern(std::string_view s);
+    Id find(std::string_view s) const;
+
+    std::string_view view(Id id) const {
+        const Entry* e = entry(id);
+        return {e->chars(), e->length};
+    }
+    const char* c_str(Id id) const { return entry(id)->chars(); }
+
+    std::size_t size() const { return size_.load(std::memory_order_acquire); }
+    // Bytes held by interned entries, hash tables and the ID index.
+    std::size_t memory_bytes() const;
+
+private:
+    struct Entry {
+        std::uint64_t hash;
+        std::uint32_t length;
+        Id id;
+        const char* chars() const { return reinterpret_cast<const char*>(this + 1); }
+    };
+
+    struct Table {
+        explicit Table(std::size_t capacity);
+        std::size_t mask;
+        std::unique_ptr<std::atomic<const Entry*>[]> slots;
+    };
+
+    // IDs index a list of chunks doubling in size, so the index grows
+    // without moving published entries.
+    static constexpr std::size_t kFirstChunk = 256;
+    static constexpr std::size_t kMaxChunks = 24;
+
+    static std::size_t chunk_of(Id id, std::size_t& offset) {
+        std::size_t scaled = static_cast<std::size_t>(id) / kFirstChunk + 1;
+        std::size_t chunk = static_cast<std::size_t>(63 - __builtin_clzll(scaled));
+        offset = static_cast<std::size_t>(id) - kFirstChunk * ((std::size_t{1} << chunk) - 1);
+        return chunk;
+    }
+
+    const Entry* entry(Id id) const {
+        std::size_t offset;
+        std::size_t chunk = chunk_of(id, offset);
+        return chunks_[chunk][offset];
+    }
+
+    const Entry* lookup(const Table& table, std::uint64_t hash, std::string_view s) const;
+    void grow();
+
+    std::atomic<Table*> table_;
+    std::atomic<std::size_t> size_{0};
+    mutable std::mutex insert_mutex_;
+    // Everything below is only written under insert_mutex_.
+    std::vector<std::unique_ptr<Table>> tables_;  // current one last
+    std::unique_ptr<const Entry*[]> chunks_[kMaxChunks];
+    Arena arena_;
+    std::size_t arena_bytes_ = 0;
+};
+
+}  // namespace stringutils
+
+#endif  // INTERN_POOL_H
@@ -0,0 +1,273 @@
+// Number parsing and formatting
+//
+// Integers go straight through std::from_chars / std::to_chars. Floating
+// point first tries Clinger's fast path: when the decimal significand fits
+// the binary mantissa exactly and the power of ten is itself exact, one
+// IEEE multiply or divide gives the correctly rounded result. Config values
+// and sensor columns ("42.5", "0.001", "1e6") almost always qualify; the
+// rest go to std::from_chars, or strtod in the "C" locale on libraries
+// without floating-point from_chars.
+#include "numeric.h"
+#include "stringutils.h"
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <system_error>
+#include <type_traits>
+#include <locale.h>
+
+namespace stringutils {
+
+const char* parse_error_name(ParseError e) noexcept {
+    switch (e) {
+        case ParseError::None:             return "none";
+        case ParseError::Empty:            return "empty field";
+        case ParseError::InvalidCharacter: return "invalid character";
+        case ParseError::OutOfRange:       return "out of range";
+        case ParseError::TooManyValues:    return "too many values";
+    }
+    return "unknown";
+}
+
+namespace {
+
+template <typename T>
+ParseResult<T> failure(ParseError e) {
+    return {T{}, e};
+}
+
+template <typename T>
+ParseResult<T> parse_integer(std::string_view s) {
+    T value{};
+    auto res = std::from_chars(s.data(), s.data() + s.size(), value);
+    if (res.ec == std::errc::result_out_of_range) return failure<T>(ParseError::OutOfRange);
+    if (res.ec != std::errc() || res.ptr != s.data() + s.size()) return failure<T>(ParseError::InvalidCharacter);
+    return {value, ParseError::None};
+}
+
+// Largest exactly representable significand and power of ten per type.
+template <typename T>
+struct FastPath;
+template <>
+struct FastPath<double> {
+    static constexpr std::uint64_t max_mantissa = std::uint64_t{1} << 53;
+    static constexpr int max_exponent = 22;
+};
+template <>
+struct FastPath<float> {
+    static constexpr std::uint64_t max_mantissa = std::uint64_t{1} << 24;
+    static constexpr int max_exponent = 10;
+};
+
+constexpr double kPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                             1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+inline bool is_digit(char c) { return static_cast<unsigned char>(c - '0') < 10; }
+
+// Returns false whenever the fast path cannot give an exact answer,
+// including every malformed input; the slow path then decides.
+template <typename T>
+bool parse_fast(std::string_view s, T& out) {
+    const char* p = s.data();
+    const char* end = p + s.size();
+    bool negative = false;
+    if (p != end && *p == '-') {
+        negative = true;
+        ++p;
+    }
+    std::uint64_t mantissa = 0;
+    int significant = 0;  // digits in mantissa, leading zeros excluded
+    int exponent = 0;
+    bool any_digit = false;
+    auto take = [&](char c) {
+        mantissa = mantissa * 10 + static_cast<unsigned>(c - '0');
+        if (mantissa != 0) ++significant;
+        any_digit = true;
+        return significant <= 19;
+    };
+    for (; p != end && is_digit(*p); ++p) {
+        if (!take(*p)) return false;
+    }
+    if (p != end && *p == '.') {
+        for (++p; p != end && is_digit(*p); ++p) {
+            if (!take(*p)) return false;
+            --exponent;
+        }
+    }
+    if (!any_digit) return false;
+    if (p != end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool negative_exp = false;
+        if (p != end && (*p == '-' || *p == '+')) negative_exp = *p++ == '-';
+        if (p == end) return false;
+        int e = 0;
+        for (; p != end && is_digit(*p); ++p) {
+            if (e > 10000) return false;
+            e = e * 10 + (*p - '0');
+        }
+        exponent += negative_exp ? -e : e;
+    }
+    if (p != end) return false;
+    if (mantissa > FastPath<T>::max_mantissa) return false;
+    if (mantissa != 0 && (exponent < -FastPath<T>::max_exponent || exponent > FastPath<T>::max_exponent)) {
+        return false;
+    }
+
+    T value = static_cast<T>(mantissa);
+    if (mantissa != 0) {
+        if (exponent < 0) {
+            value /= static_cast<T>(kPow10[-exponent]);
+        } else {
+            value *= static_cast<T>(kPow10[exponent]);
+        }
+    }
+    out = negative ? -value : value;
+    return true;
+}
+
+#if !defined(__cpp_lib_to_chars)
+// strtod and snprintf follow LC_NUMERIC: switches the calling thread to the
+// "C" locale for the scope. Falls back to the global locale only if a "C"
+// locale object cannot be created.
+class CLocaleScope {
+public:
+    CLocaleScope() {
+        static const locale_t c_locale = newlocale(LC_ALL_MASK, "C", static_cast<locale_t>(0));
+        if (c_locale != static_cast<locale_t>(0)) previous_ = uselocale(c_locale);
+    }
+    ~CLocaleScope() {
+        if (previous_ != static_cast<locale_t>(0)) uselocale(previous_);
+    }
+    CLocaleScope(const CLocaleScope&) = delete;
+    CLocaleScope& operator=(const CLocaleScope&) = delete;
+
+private:
+    locale_t previous_ = static_cast<locale_t>(0);
+};
+#endif
+
+template <typename T>
+ParseResult<T> parse_slow(std::string_view s) {
+#if defined(__cpp_lib_to_chars)
+    T value{};
+    auto res = std::from_chars(s.data(), s.data() + s.size(), value);
+    if (res.ec == std::errc::result_out_of_range) return failure<T>(ParseError::OutOfRange);
+    if (res.ec != std::errc() || res.ptr != s.data() + s.size()) return failure<T>(ParseError::InvalidCharacter);
+    return {value, ParseError::None};
+#else
+    // strtod also takes leading blanks, '+' and hex; from_chars does not.
+    if (s[0] == '+' || s[0] == ' ' || s[0] == '\t' || s.find_first_of("xX") != std::string_view::npos) {
+        return failure<T>(ParseError::InvalidCharacter);
+    }
+    // strtod needs a terminator; long literals (many digits) go to the heap.
+    char stack[128];
+    std::unique_ptr<char[]> heap;
+    char* buf = stack;
+    if (s.size() >= sizeof(stack)) {
+        heap.reset(new (std::nothrow) char[s.size() + 1]);
+        if (!heap) return failure<T>(ParseError::OutOfRange);  // out of memory, not a bad value
+        buf = heap.get();
+    }
+    std::memcpy(buf, s.data(), s.size());
+    buf[s.size()] = '\0';
+    char* parsed = nullptr;
+    errno = 0;
+    T value;
+    {
+        CLocaleScope c_locale;
+        value = std::is_same_v<T, float> ? std::strtof(buf, &parsed) : static_cast<T>(std::strtod(buf, &parsed));
+    }
+    if (parsed != buf + s.size()) return failure<T>(ParseError::InvalidCharacter);
+    // ERANGE also flags subnormal results, which are valid values.
+    if (errno == ERANGE && (std::isinf(value) || value == 0)) return failure<T>(ParseError::OutOfRange);
+    return {value, ParseError::None};
+#endif
+}
+
+template <typename T>
+std::size_t format_floating(T value, char* out, std::size_t size) {
+#if defined(__cpp_lib_to_chars)
+    auto res = std::to_chars(out, out + size, value);
+    return res.ec == std::errc() ? static_cast<std::size_t>(res.ptr - out) : 0;
+#else
+    // The fewest significant digits that read back as the same value; 9
+    // (float) or 17 (double) always do.
+    char buf[kMaxNumberChars];
+    CLocaleScope c_locale;
+    const int max_digits = std::is_same_v<T, float> ? 9 : 17;
+    int len = 0;
+    for (int digits = 1; digits <= max_digits; ++digits) {
+        len = std::snprintf(buf, sizeof(buf), "%.*g", digits, static_cast<double>(value));
+        if (len <= 0 || std::isnan(value)) break;
+        T back = std::is_same_v<T, float> ? std::strtof(buf, nullptr) : static_cast<T>(std::strtod(buf, nullptr));
+        if (back == value) break;
+    }
+    if (len <= 0 || static_cast<std::size_t>(len) > size) return 0;
+    std::memcpy(out, buf, static_cast<std::size_t>(len));
+    return static_cast<std::size_t>(len);
+#endif
+}
+
+}  // namespace
+
+template <typename T>
+ParseResult<T> parse_number(std::string_view s) noexcept {
+    if (s.empty()) return failure<T>(ParseError::Empty);
+    if constexpr (std::is_integral_v<T>) {
+        return parse_integer<T>(s);
+    } else {
+        T value;
+        if (parse_fast(s, value)) return {value, ParseError::None};
+        return parse_slow<T>(s);
+    }
+}
+
+template <typename T>
+std::size_t format_number(T value, char* out, std::size_t size) noexcept {
+    if constexpr (std::is_integral_v<T>) {
+        auto res = std::to_chars(out, out + size, value);
+        return res.ec == std::errc() ? static_cast<std::size_t>(res.ptr - out) : 0;
+    } else {
+        return format_floating(value, out, size);
+    }
+}
+
+template <typename T>
+ColumnResult parse_column(std::string_view text, char delimiter, T* out, std::size_t capacity) noexcept {
+    ColumnResult result;
+    for (std::string_view field : split_view(text, delimiter)) {
+        if (result.count == capacity) {
+            result.error = ParseError::TooManyValues;
+            break;
+        }
+        ParseResult<T> parsed = parse_number<T>(trim_view(field));
+        if (!parsed) {
+            result.error = parsed.error;
+            break;
+        }
+        out[result.count++] = parsed.value;
+    }
+    return result;
+}
+
+#define STRINGUTILS_NUMERIC_INSTANTIATE(T)                                              \
+    template ParseResult<T> parse_number<T>(std::string_view) noexcept;                 \
+    template std::size_t format_number<T>(T, char*, std::size_t) noexcept;              \
+    template ColumnResult parse_column<T>(std::string_view, char, T*, std::size_t) noexcept;
+STRINGUTILS_NUMERIC_INSTANTIATE(int)
+STRINGUTILS_NUMERIC_INSTANTIATE(long)
+STRINGUTILS_NUMERIC_INSTANTIATE(long long)
+STRINGUTILS_NUMERIC_INSTANTIATE(unsigned)
+STRINGUTILS_NUMERIC_INSTANTIATE(unsigned long)
+STRINGUTILS_NUMERIC_INSTANTIATE(unsigned long long)
+STRINGUTILS_NUMERIC_INSTANTIATE(float)
+STRINGUTILS_NUMERIC_INSTANTIATE(double)
+#undef STRINGUTILS_NUMERIC_INSTANTIATE
+
+}  // namespace stringutils
@@ -0,0 +1,57 @@
+// Shared library: locale-free number parsing and formatting
+#ifndef NUMERIC_H
+#define NUMERIC_H
+
+#include <cstddef>
+#include <string_view>
+
+namespace stringutils {
+
+// Parsing never allocates, never throws and ignores the C locale. The
+// whole view must be the number: no surrounding whitespace, no leading
+// '+', no hex. Floating point accepts what strtod does in the "C" locale
+// otherwise (".5", "1e-3", "inf", "nan").
+enum class ParseError { None, Empty, InvalidCharacter, OutOfRange, TooManyValues };
+
+const char* parse_error_name(ParseError e) noexcept;
+
+template <typename T>
+struct ParseResult {
+    T value{};
+    ParseError error = ParseError::None;
+
+    constexpr bool ok() const noexcept { return error == ParseError::None; }
+    constexpr explicit operator bool() const noexcept { return ok(); }
+};
+
+// parse_number, format_number and parse_column are defined for int, long,
+// long long, their unsigned forms, float and double.
+template <typename T>
+ParseResult<T> parse_number(std::string_view s) noexcept;
+
+// Large enough for any value format_number writes.
+constexpr std::size_t kMaxNumberChars = 32;
+
+// Writes the shortest text that parses back to the same value; returns
+// the number of chars written, or 0 if `size` is too small. No terminator.
+template <typename T>
+std::size_t format_number(T value, char* out, std::size_t size) noexcept;
+
+// Batch parse of a delimited column ("1,2,3" or one value per line) into
+// caller storage. Fields are trimmed of blanks; like split(), a trailing
+// delimiter does not add an empty field. Stops at the first bad field,
+// with `count` values already stored, so field number `count` is the bad
+// one. More fields than `capacity` is TooManyValues.
+struct ColumnResult {
+    std::size_t count = 0;
+    ParseError error = ParseError::None;
+
+    constexpr bool ok() const noexcept { return error == ParseError::None; }
+};
+
+template <typename T>
+ColumnResult parse_column(std::string_view text, char delimiter, T* out, std::size_t capacity) noexcept;
+
+}  // namespace stringutils
+
+#endif  // NUMERIC_H
@@ -0,0 +1,135 @@
+// Multi-pattern replacer implementation
+#include "replacer.h"
+#include <algorithm>
+#include <queue>
+#include <stdexcept>
+
+namespace stringutils {
+
+Replacer::Replacer(std::vector<std::pair<std::string, std::string>> rules) : rules_(std::move(rules)) {
+    for (const auto& r : rules_) {
+        if (r.first.empty()) throw std::invalid_argument("empty replacement pattern");
+        for (unsigned char c : r.first) {
+            if (byte_class_[c] == 0) byte_class_[c] = static_cast<std::uint16_t>(classes_++);
+        }
+        longest_ = std::max(longest_, r.first.size());
+    }
+
+    // Trie with explicit child transitions; kNone marks a missing edge.
+    delta_.assign(classes_, kNone);
+    out_.push_back(kNone);
+    depth_.push_back(0);
+    for (std::size_t r = 0; r < rules_.size(); ++r) {
+        std::int32_t s = 0;
+        for (unsigned char c : rules_[r].first) {
+            std::size_t slot = static_cast<std::size_t>(s) * classes_ + byte_class_[c];
+            if (delta_[slot] == kNone) {
+                delta_[slot] = static_cast<std::int32_t>(out_.size());
+                out_.push_back(kNone);
+                depth_.push_back(depth_[static_cast<std::size_t>(s)] + 1);
+                delta_.resize(delta_.size() + classes_, kNone);
+            }
+            s = delta_[slot];
+        }
+        // Keep the first rule for duplicate patterns.
+        if (out_[static_cast<std::size_t>(s)] == kNone) out_[static_cast<std::size_t>(s)] = static_cast<std::int32_t>(r);
+    }
+
+    // Breadth-first: fill failure transitions so delta_ becomes a DFA, and
+    // link each state to the nearest proper suffix state with an output.
+    std::vector<std::int32_t> fail(out_.size(), 0);
+    dict_.assign(out_.size(), kNone);
+    std::queue<std::int32_t> queue;
+    for (std::size_t c = 0; c < classes_; ++c) {
+        std::int32_t& next = delta_[c];
+        if (next == kNone) {
+            next = 0;
+        } else {
+            queue.push(next);
+        }
+    }
+    while (!queue.empty()) {
+        std::int32_t s = queue.front();
+        queue.pop();
+        for (std::size_t c = 0; c < classes_; ++c) {
+            std::size_t slot = static_cast<std::size_t>(s) * classes_ + c;
+            std::int32_t via_fail = delta_[static_cast<std::size_t>(fail[static_cast<std::size_t>(s)]) * classes_ + c];
+            if (delta_[slot] == kNone) {
+                delta_[slot] = via_fail;
+                continue;
+            }
+            std::int32_t child = delta_[slot];
+            fail[static_cast<std::size_t>(child)] = via_fail;
+            dict_[static_cast<std::size_t>(child)] =
+                out_[static_cast<std::size_t>(via_fail)] != kNone ? via_fail : dict_[static_cast<std::size_t>(via_fail)];
+            queue.push(child);
+        }
+    }
+}
+
+std::string Replacer::apply(std::string_view input) const {
+    std::string out;
+    apply(input, out);
+    return out;
+}
+
+void Replacer::apply(std::string_view input, std::string& out) const {
+    out.clear();
+    const std::size_t n = input.size();
+    if (rules_.empty()) {
+        out.assign(input.data(), n);
+        return;
+    }
+    // Without a lengthening rule the output is at most n bytes, so this is
+    // the only allocation; otherwise appends grow it geometrically.
+    out.reserve(n);
+
+    // One pass. Matches are found by end position; every match starting at
+    // `pos` has ended once the scan is longest_ - 1 bytes past it, so each
+    // position is decided with a delay of at most longest_ bytes. `best`
+    // holds the longest rule per start for the undecided window [pos, i]:
+    // matches sharing a start are found in order of increasing end and
+    // duplicate patterns map to one state, so the last write is the longest.
+    const std::size_t window = longest_;
+    thread_local std::vector<std::int32_t> best;
+    best.assign(window, kNone);
+    const std::int32_t* delta = delta_.data();
+    const std::int32_t* rule_at = out_.data();
+    const std::int32_t* dict = dict_.data();
+    const std::int32_t* depth = depth_.data();
+    std::size_t pos = 0;  // first undecided position
+    std::size_t run = 0;  // start of the literal text not yet copied
+
+    // Decides every position before `limit`.
+    auto settle = [&](std::size_t limit) {
+        while (pos < limit) {
+            std::int32_t& slot = best[pos % window];
+            if (slot == kNone) {
+                ++pos;
+                continue;
+            }
+            const auto& r = rules_[static_cast<std::size_t>(slot)];
+            out.append(input.data() + run, pos - run);
+            out.append(r.second);
+            // Matches starting inside the replaced text are discarded.
+            for (std::size_t k = 0; k < r.first.size(); ++k) best[(pos + k) % window] = kNone;
+            pos += r.first.size();
+            run = pos;
+        }
+    };
+
+    std::size_t s = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        s = static_cast<std::size_t>(delta[s * classes_ + byte_class_[static_cast<unsigned char>(input[i])]]);
+        std::int32_t m = rule_at[s] != kNone ? static_cast<std::int32_t>(s) : dict[s];
+        for (; m != kNone; m = dict[m]) {
+            std::size_t start = i + 1 - static_cast<std::size_t>(depth[m]);
+            if (start >= pos) best[start % window] = rule_at[m];
+        }
+        if (i + 2 > window) settle(i + 2 - window);
+    }
+    settle(n);
+    out.append(input.data() + run, n - run);
+}
+
+}  // namespace stringutils
@@ -0,0 +1,49 @@
+// Shared library: compiled multi-pattern replacement
+#ifndef REPLACER_H
+#define REPLACER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace stringutils {
+
+// Applies a fixed set of (from, to) substitutions in one left-to-right
+// pass. Built once into an Aho-Corasick automaton over a compressed byte
+// alphabet, so matching costs one table lookup per input byte however
+// many rules there are.
+//
+// Matching is leftmost-longest and non-overlapping: at each position the
+// longest rule starting there wins (ties go to the earlier rule), and
+// replaced text is not rescanned. Throws std::invalid_argument for an
+// empty `from`.
+class Replacer {
+public:
+    explicit Replacer(std::vector<std::pair<std::string, std::string>> rules);
+
+    std::string apply(std::string_view input) const;
+    // Writes into `out` (cleared first) so callers can reuse its capacity.
+    void apply(std::string_view input, std::string& out) const;
+
+    std::size_t rule_count() const { return rules_.size(); }
+    std::size_t state_count() const { return out_.size(); }
+
+private:
+    static constexpr std::int32_t kNone = -1;
+
+    std::vector<std::pair<std::string, std::string>> rules_;
+    // Up to 257 classes (class 0: bytes in no pattern), so wider than a byte.
+    std::uint16_t byte_class_[256] = {};
+    std::size_t classes_ = 1;
+    std::size_t longest_ = 0;             // longest pattern, in bytes
+    std::vector<std::int32_t> delta_;     // state * classes_ + class -> state
+    std::vector<std::int32_t> out_;       // rule whose pattern is the state's string
+    std::vector<std::int32_t> depth_;     // length of the state's string
+    std::vector<std::int32_t> dict_;      // next state on the suffix chain with output
+};
+
+}  // namespace stringutils
+
+#endif  // REPLACER_H
@@ -0,0 +1,211 @@
+// Precompiled substring search
+//
+// Packed filter: for every candidate start i, compare haystack[i] with the
+// first needle byte and haystack[i + m - 1] with the last one, a vector
+// width of candidates at a time. Only positions passing both go on to a
+// memcmp of the middle bytes, so on ordinary text almost every block is
+// rejected by two compares and a movemask.
+#include "searcher.h"
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace stringutils {
+
+namespace {
+
+constexpr std::size_t npos = Searcher::npos;
+
+// Collects non-overlapping matches inside a kernel so find_all does not
+// restart the scan after every hit. `base` converts kernel offsets back to
+// haystack offsets.
+struct Hits {
+    std::vector<std::size_t>* out;
+    std::size_t base;
+    std::size_t next = 0;  // first start not overlapping the previous hit
+
+    void add(std::size_t at, std::size_t m) {
+        if (at < next) return;
+        out->push_back(base + at);
+        next = at + m;
+    }
+};
+
+// Packed kernels take m >= 2. Without a sink they return the first match
+// as an offset from h, or npos; with one they report every match to it
+// and return npos.
+std::size_t scalar_packed(const char* h, std::size_t n, const char* nd, std::size_t m, Hits* hits) {
+    if (n < m) return npos;
+    const char* end = h + (n - m) + 1;  // one past the last candidate start
+    for (const char* p = h; p < end; ++p) {
+        p = static_cast<const char*>(std::memchr(p, nd[0], static_cast<std::size_t>(end - p)));
+        if (p == nullptr) return npos;
+        if (p[m - 1] == nd[m - 1] && std::memcmp(p + 1, nd + 1, m - 2) == 0) {
+            auto at = static_cast<std::size_t>(p - h);
+            if (hits == nullptr) return at;
+            hits->add(at, m);
+        }
+    }
+    return npos;
+}
+
+std::size_t finish_scalar(const char* h, std::size_t n, std::size_t i, const char* nd, std::size_t m, Hits* hits) {
+    if (hits != nullptr) {
+        Hits tail{hits->out, hits->base + i, hits->next > i ? hits->next - i : 0};
+        return scalar_packed(h + i, n - i, nd, m, &tail);
+    }
+    std::size_t r = scalar_packed(h + i, n - i, nd, m, nullptr);
+    return r == npos ? npos : i + r;
+}
+
+#if defined(__x86_64__)
+std::size_t sse2_packed(const char* h, std::size_t n, const char* nd, std::size_t m, Hits* hits) {
+    const __m128i first = _mm_set1_epi8(nd[0]);
+    const __m128i last = _mm_set1_epi8(nd[m - 1]);
+    std::size_t i = 0;
+    for (; i + m + 15 <= n; i += 16) {
+        __m128i f = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i)), first);
+        __m128i l = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i + m - 1)), last);
+        auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(f, l)));
+        for (; mask != 0; mask &= mask - 1) {
+            auto bit = static_cast<std::size_t>(__builtin_ctz(mask));
+            if (std::memcmp(h + i + bit + 1, nd + 1, m - 2) != 0) continue;
+            if (hits == nullptr) return i + bit;
+            hits->add(i + bit, m);
+        }
+    }
+    return finish_scalar(h, n, i, nd, m, hits);
+}
+
+__attribute__((target("avx2")))
+std::size_t avx2_packed(const char* h, std::size_t n, const char* nd, std::size_t m, Hits* hits) {
+    const __m256i first = _mm256_set1_epi8(nd[0]);
+    const __m256i last = _mm256_set1_epi8(nd[m - 1]);
+    std::size_t i = 0;
+    for (; i + m + 31 <= n; i += 32) {
+        __m256i f = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i)), first);
+        __m256i l = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i + m - 1)), last);
+        auto mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(f, l)));
+        for (; mask != 0; mask &= mask - 1) {
+            auto bit = static_cast<std::size_t>(__builtin_ctz(mask));
+            if (std::memcmp(h + i + bit + 1, nd + 1, m - 2) != 0) continue;
+            if (hits == nullptr) {
+                _mm256_zeroupper();
+                return i + bit;
+            }
+            hits->add(i + bit, m);
+        }
+    }
+    _mm256_zeroupper();
+    return finish_scalar(h, n, i, nd, m, hits);
+}
+
+using PackedFn = std::size_t (*)(const char*, std::size_t, const char*, std::size_t, Hits*);
+
+PackedFn select_packed() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? avx2_packed : sse2_packed;
+}
+
+std::size_t packed_find(const char* h, std::size_t n, const char* nd, std::size_t m, Hits* hits) {
+    static const PackedFn fn = select_packed();
+    return fn(h, n, nd, m, hits);
+}
+#elif defined(__aarch64__)
+std::size_t packed_find(const char* h, std::size_t n, const char* nd, std::size_t m, Hits* hits) {
+    const uint8x16_t first = vdupq_n_u8(static_cast<std::uint8_t>(nd[0]));
+    const uint8x16_t last = vdupq_n_u8(static_cast<std::uint8_t>(nd[m - 1]));
+    const auto* u = reinterpret_cast<const std::uint8_t*>(h);
+    std::size_t i = 0;
+    for (; i + m + 15 <= n; i += 16) {
+        uint8x16_t eq = vandq_u8(vceqq_u8(vld1q_u8(u + i), first), vceqq_u8(vld1q_u8(u + i + m - 1), last));
+        // No movemask on NEON: narrowing by 4 leaves one nibble per byte.
+        std::uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+        while (mask != 0) {
+            auto bit = static_cast<std::size_t>(__builtin_ctzll(mask)) >> 2;
+            mask &= ~(std::uint64_t{0xF} << (bit * 4));
+            if (std::memcmp(h + i + bit + 1, nd + 1, m - 2) != 0) continue;
+            if (hits == nullptr) return i + bit;
+            hits->add(i + bit, m);
+        }
+    }
+    return finish_scalar(h, n, i, nd, m, hits);
+}
+#else
+std::size_t packed_find(const char* h, std::size_t n, const char* nd, std::size_t m, Hits* hits) {
+    return scalar_packed(h, n, nd, m, hits);
+}
+#endif
+
+}  // namespace
+
+Searcher::Searcher(std::string needle) : needle_(std::move(needle)) {
+    const std::size_t m = needle_.size();
+    if (m == 0) throw std::invalid_argument("empty needle");
+    if (m == 1) {
+        kind_ = Kind::Byte;
+    } else if (m <= kPackedMax) {
+        kind_ = Kind::Packed;
+    } else {
+        kind_ = Kind::Horspool;
+        for (auto& s : shift_) s = m;
+        for (std::size_t i = 0; i + 1 < m; ++i) shift_[static_cast<unsigned char>(needle_[i])] = m - 1 - i;
+    }
+}
+
+std::size_t Searcher::find(std::string_view haystack, std::size_t pos) const {
+    if (pos >= haystack.size()) return npos;
+    const char* h = haystack.data() + pos;
+    const std::size_t n = haystack.size() - pos;
+    const std::size_t m = needle_.size();
+    const char* nd = needle_.data();
+
+    switch (kind_) {
+    case Kind::Byte: {
+        const void* p = std::memchr(h, nd[0], n);
+        return p == nullptr ? npos : static_cast<std::size_t>(static_cast<const char*>(p) - haystack.data());
+    }
+    case Kind::Packed: {
+        std::size_t r = packed_find(h, n, nd, m, nullptr);
+        return r == npos ? npos : pos + r;
+    }
+    case Kind::Horspool:
+        break;
+    }
+
+    const unsigned char last = static_cast<unsigned char>(nd[m - 1]);
+    for (std::size_t i = 0; i + m <= n;) {
+        auto c = static_cast<unsigned char>(h[i + m - 1]);
+        if (c == last && std::memcmp(h + i, nd, m - 1) == 0) return pos + i;
+        i += shift_[c];
+    }
+    return npos;
+}
+
+std::vector<std::size_t> Searcher::find_all(std::string_view haystack) const {
+    std::vector<std::size_t> hits;
+    find_all(haystack, hits);
+    return hits;
+}
+
+std::size_t Searcher::find_all(std::string_view haystack, std::vector<std::size_t>& out) const {
+    const std::size_t before = out.size();
+    if (kind_ == Kind::Packed) {
+        Hits hits{&out, 0};
+        packed_find(haystack.data(), haystack.size(), needle_.data(), needle_.size(), &hits);
+        return out.size() - before;
+    }
+    for (std::size_t pos = find(haystack); pos != npos; pos = find(haystack, pos + needle_.size())) {
+        out.push_back(pos);
+    }
+    return out.size() - before;
+}
+
+}  // namespace stringutils
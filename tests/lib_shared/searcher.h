@@ -0,0 +1,49 @@
+// Shared library: precompiled substring search
+#ifndef SEARCHER_H
+#define SEARCHER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace stringutils {
+
+// A needle prepared once for repeated searches. Short needles scan the
+// haystack with a vectorized filter (AVX2 / SSE2 / NEON) that keeps only
+// positions where both the first and the last needle byte match, then
+// verify the bytes in between. Needles longer than kPackedMax use
+// Boyer-Moore-Horspool, whose skip grows with the needle length.
+//
+// Throws std::invalid_argument for an empty needle.
+class Searcher {
+public:
+    static constexpr std::size_t npos = std::string_view::npos;
+    static constexpr std::size_t kPackedMax = 64;
+
+    explicit Searcher(std::string needle);
+
+    // Offset of the first match at or after pos, or npos.
+    std::size_t find(std::string_view haystack, std::size_t pos = 0) const;
+    bool contains(std::string_view haystack) const { return find(haystack) != npos; }
+
+    // Offsets of all non-overlapping matches, left to right (the same
+    // matches replace_all substitutes).
+    std::vector<std::size_t> find_all(std::string_view haystack) const;
+    // Appends to `out` so callers can reuse its capacity; returns the number
+    // of matches appended.
+    std::size_t find_all(std::string_view haystack, std::vector<std::size_t>& out) const;
+
+    const std::string& needle() const { return needle_; }
+
+private:
+    enum class Kind { Byte, Packed, Horspool };
+
+    std::string needle_;
+    Kind kind_;
+    std::size_t shift_[256] = {};  // Horspool only
+};
+
+}  // namespace stringutils
+
+#endif  // SEARCHER_H
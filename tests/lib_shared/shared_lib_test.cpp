@@ -2,7 +2,35 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <unistd.h>
 #include "stringutils.h"
+#include "csv.h"
+#include "intern_pool.h"
+#include "numeric.h"
+#include "replacer.h"
+#include "searcher.h"
+#include "string_builder.h"
+#include "utf8.h"
+
+// Counts heap allocations so the builder and join checks can assert on them.
+// The intern-pool workers and parse_csv_parallel() allocate on other threads.
+static std::atomic<std::size_t> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
 
 int main() {
     std::cout << "=== Shared library test ===\n";
@@ -20,6 +48,301 @@ int main() {
     std::cout << "contains: " << stringutils::contains("hello world", "world") << "\n";
     std::cout << "replace_all: " << stringutils::replace_all("foo bar foo", "foo", "baz") << "\n";
 
+    // string_view variants: no allocation per token
+    std::cout << "trim_view: '" << stringutils::trim_view("\t view \n") << "'\n";
+    std::cout << "starts_with/ends_with: " << stringutils::starts_with("qnx.cfg", "qnx")
+              << stringutils::ends_with("qnx.cfg", ".cfg") << stringutils::starts_with("q", "qnx") << "\n";
+    std::cout << "split_view: ";
+    for (auto t : stringutils::split_view("k1 := v1 := v2", " := ", 1)) std::cout << "[" << t << "] ";
+    std::cout << "\n";
+    for (std::string input : {"", ",", "a", "a,", ",a", "a,,b", "one,two,three", ",,"}) {
+        auto owned = stringutils::split(input, ',');
+        auto views = stringutils::split_view(input, ',').to_vector();
+        if (owned.size() != views.size() || !std::equal(owned.begin(), owned.end(), views.begin())) {
+            std::cout << "split_view mismatch for '" << input << "'\n";
+            return 1;
+        }
+    }
+
+    // Case conversion kernels vs std::toupper/std::tolower ("C" locale) on
+    // every byte value, at lengths and offsets that exercise vector tails
+    {
+        std::string all;
+        for (int rep = 0; rep < 3; ++rep)
+            for (int c = 0; c < 256; ++c) all += static_cast<char>(c);
+        bool ok = true;
+        for (std::size_t off = 0; off < 5 && ok; ++off) {
+            for (std::size_t len : {0, 1, 15, 16, 17, 31, 33, 63, 64, 65, 300, 700}) {
+                std::string in = all.substr(off, len);
+                std::string up_ref = in, low_ref = in;
+                for (auto& c : up_ref) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+                for (auto& c : low_ref) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                std::string buf(len, '\0');
+                stringutils::to_lower(in, &buf[0]);
+                std::string inplace = in;
+                stringutils::to_upper_inplace(inplace);
+                ok = ok && stringutils::to_upper(in) == up_ref && inplace == up_ref &&
+                     stringutils::to_lower(in) == low_ref && buf == low_ref;
+            }
+        }
+        std::string shout = "utf-8 caf\xc3\xa9 ok";
+        stringutils::to_upper_inplace(shout);
+        std::cout << "to_upper_inplace: " << shout << (ok ? "" : " (kernel MISMATCH)") << "\n";
+        if (!ok) return 1;
+    }
+
+    // Compiled multi-pattern replacer: leftmost-longest, single pass
+    {
+        stringutils::Replacer sanitize({{"<", "&lt;"}, {">", "&gt;"}, {"&", "&amp;"},
+                                        {"he", "HE"}, {"hers", "HERS"}, {"she", "SHE"}});
+        std::string out = sanitize.apply("ushers <b>& his");
+        bool ok = out == "uSHErs &lt;b&gt;&amp; his" &&
+                  sanitize.apply("hershe") == "HERSHE" && sanitize.apply("") == "" &&
+                  stringutils::replace_all("aaa", "a", "bb") == "bbbbbb" &&
+                  stringutils::replace_all("abc", "", "x") == "abc";
+
+        // Every byte value in some pattern: 256 byte classes plus the
+        // no-pattern class
+        std::vector<std::pair<std::string, std::string>> bytes;
+        for (int b = 0; b < 256; ++b) bytes.push_back({std::string(1, static_cast<char>(b)), "<" + std::to_string(b) + ">"});
+        bytes.push_back({"\xff\xff", "<ffff>"});
+        stringutils::Replacer all_bytes(std::move(bytes));
+        ok = ok && all_bytes.apply(std::string("\xff" "Z" "\0", 3)) == "<255><90><0>" &&
+             all_bytes.apply("\xff\xff\xff") == "<ffff><255>";
+        std::cout << "replacer: " << out << (ok ? "" : " (MISMATCH)") << "\n";
+        if (!ok) return 1;
+    }
+
+    // Precompiled searcher: byte, packed-filter and Horspool needles must all
+    // agree with std::string_view::find
+    {
+        std::string text;
+        for (int i = 0; i < 40; ++i) text += "node-" + std::to_string(i) + " status=OK latency=" + std::to_string(i * 7) + "us\n";
+        const std::string_view hay(text);
+        bool ok = true;
+        const std::vector<std::string> needles = {
+            "\n", "OK", "status=", "node-39 status=OK", "latency=273us\nnode-",
+            "node-38 status=OK latency=266us\nnode-39 status=OK", "absent",
+            text.substr(200, 100), text.substr(200, 99) + "#"};
+        for (const auto& needle : needles) {
+            stringutils::Searcher searcher(needle);
+            std::vector<std::size_t> expect;
+            for (auto p = hay.find(needle); p != std::string_view::npos; p = hay.find(needle, p + needle.size()))
+                expect.push_back(p);
+            ok = ok && searcher.find_all(hay) == expect && searcher.find(hay, 100) == hay.find(needle, 100) &&
+                 searcher.contains(hay) == !expect.empty();
+        }
+        stringutils::Searcher overlap("aa");
+        ok = ok && overlap.find_all("aaaaa") == std::vector<std::size_t>{0, 2};
+        std::cout << "searcher: " << stringutils::Searcher("OK").find_all(hay).size() << " hits"
+                  << (ok ? "" : " (MISMATCH)") << "\n";
+        if (!ok) return 1;
+    }
+
+    // Presized join and the string builder: at most one allocation each
+    {
+        std::vector<std::string> words;
+        for (int i = 0; i < 64; ++i) words.push_back("field-" + std::to_string(i));
+        std::size_t before = g_allocations;
+        std::string joined = stringutils::join(words, ", ");
+        std::size_t join_allocs = g_allocations - before;
+
+        before = g_allocations;
+        stringutils::StringBuilder sb;
+        sb << "Config set: " << std::string_view("port") << " = " << 8080 << ' ' << -42L << ' ' << 7u
+           << ' ' << 0.5 << ' ' << true;
+        std::size_t inline_allocs = g_allocations - before;
+        std::string built = sb.str();
+        std::size_t built_allocs = g_allocations - before;
+
+        stringutils::Arena arena;
+        stringutils::StringBuilder big(arena);
+        for (const auto& w : words) big << w << ',';
+        before = g_allocations;
+        for (const auto& w : words) big << w << ',';
+        std::size_t arena_allocs = g_allocations - before;
+
+        bool ok = joined.substr(0, 17) == "field-0, field-1," &&
+                  join_allocs == 1 && inline_allocs == 0 && built_allocs == 1 &&
+                  built == "Config set: port = 8080 -42 7 0.5 true" && arena_allocs == 0 &&
+                  big.size() == 2 * (joined.size() - 2 * 63 + 64) && arena.block_count() == 1;
+        std::cout << "builder: " << built << " (join " << join_allocs << " alloc, build " << built_allocs
+                  << " alloc)" << (ok ? "" : " (MISMATCH)") << "\n";
+        if (!ok) return 1;
+    }
+
+    // Locale-free number parsing: error codes instead of exceptions
+    {
+        using stringutils::ParseError;
+        auto port = stringutils::parse_number<int>("8080");
+        auto rate = stringutils::parse_number<double>("42.5");
+        bool ok = port && port.value == 8080 && rate && rate.value == 42.5 &&
+                  stringutils::parse_number<double>("1e-3").value == 0.001 &&
+                  stringutils::parse_number<double>("-0.1").value == -0.1 &&
+                  stringutils::parse_number<float>("3.14159").value == 3.14159f &&
+                  stringutils::parse_number<double>("123456789012345678901234").value == 123456789012345678901234.0 &&
+                  stringutils::parse_number<int>("").error == ParseError::Empty &&
+                  stringutils::parse_number<int>(" 1").error == ParseError::InvalidCharacter &&
+                  stringutils::parse_number<int>("80x").error == ParseError::InvalidCharacter &&
+                  stringutils::parse_number<int>("99999999999").error == ParseError::OutOfRange &&
+                  stringutils::parse_number<unsigned>("-1").error == ParseError::InvalidCharacter &&
+                  stringutils::parse_number<double>("1e999").error == ParseError::OutOfRange &&
+                  stringutils::parse_number<double>("4.2.5").error == ParseError::InvalidCharacter &&
+                  // a long but ordinary literal: 1.5 spelled with 200 leading zeros
+                  stringutils::parse_number<double>("0." + std::string(200, '0') + "15e201").value == 1.5;
+
+        char buf[stringutils::kMaxNumberChars];
+        std::string formatted(buf, stringutils::format_number(0.1, buf, sizeof(buf)));
+        formatted += ' ';
+        formatted.append(buf, stringutils::format_number(-9223372036854775807LL - 1, buf, sizeof(buf)));
+        ok = ok && formatted == "0.1 -9223372036854775808" && stringutils::format_number(123456, buf, 3) == 0;
+
+        double column[4];
+        auto col = stringutils::parse_column<double>("1.5, 2,\t-3e2\r\n", ',', column, 4);
+        ok = ok && col.ok() && col.count == 3 && column[0] == 1.5 && column[2] == -300.0;
+        auto bad = stringutils::parse_column<double>("1\n2\nx\n4\n", '\n', column, 4);
+        auto full = stringutils::parse_column<double>("1,2,3,4,5", ',', column, 4);
+        ok = ok && bad.error == ParseError::InvalidCharacter && bad.count == 2 &&
+             full.error == ParseError::TooManyValues && full.count == 4;
+        std::cout << "numbers: " << formatted << ", bad column field " << bad.count << ": "
+                  << stringutils::parse_error_name(bad.error) << (ok ? "" : " (MISMATCH)") << "\n";
+        if (!ok) return 1;
+    }
+
+    // Intern pool: stable IDs and pointers, concurrent interning agrees
+    {
+        stringutils::InternPool pool;
+        auto first = pool.intern("sensor.temp");
+        const char* stable = pool.c_str(first);
+        std::vector<std::vector<stringutils::InternPool::Id>> ids(4);
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < ids.size(); ++t) {
+            workers.emplace_back([&pool, &ids, t] {
+                for (int i = 0; i < 5000; ++i) ids[t].push_back(pool.intern("key." + std::to_string((i * 7 + t) % 3000)));
+            });
+        }
+        for (auto& w : workers) w.join();
+        // A default string_view has a null data(); it interns as "".
+        auto empty = pool.intern(std::string_view{});
+        bool ok = pool.intern("") == empty && std::string(pool.c_str(empty)).empty() && pool.size() == 3002;
+        ok = ok && pool.intern("sensor.temp") == first && pool.c_str(first) == stable &&
+                  std::string(stable) == "sensor.temp" && pool.find("missing") == stringutils::InternPool::kNotFound;
+        for (std::size_t t = 0; t < ids.size(); ++t) {
+            for (int i = 0; i < 5000; ++i) {
+                std::string key = "key." + std::to_string((i * 7 + t) % 3000);
+                ok = ok && pool.view(ids[t][i]) == key && pool.find(key) == ids[t][i];
+            }
+        }
+        std::cout << "intern pool: " << pool.size() << " strings, " << pool.memory_bytes() << " bytes"
+                  << (ok ? "" : " (MISMATCH)") << "\n";
+        if (!ok) return 1;
+    }
+
+    // UTF-8 validation at every offset across a vector block, and
+    // round trips through UTF-16 and UTF-32
+    {
+        const std::string text = "temp 21\xc2\xb0" "C, \xd0\xb4\xd0\xb0\xd1\x82\xd1\x87\xd0\xb8\xd0\xba, "
+                                 "\xe6\xb8\xa9\xe5\xba\xa6, ok \xf0\x9f\x91\x8d";
+        bool ok = stringutils::is_valid_utf8(text);
+        const std::string bad[] = {"\x80", "\xc0\xaf", "\xe0\x80\xaf", "\xed\xa0\x80", "\xf4\x90\x80\x80",
+                                   "\xf8\x88\x80\x80\x80", "\xe2\x82", "\xf0\x9f\x91"};
+        for (const auto& b : bad) {
+            for (std::size_t at = 0; at < 70; ++at) {
+                std::string s = std::string(at, 'x') + b + (at % 2 ? "" : "tail");
+                ok = ok && stringutils::find_invalid_utf8(s) == at;
+            }
+        }
+
+        std::u16string u16(stringutils::utf16_length_from_utf8(text), u'\0');
+        std::u32string u32(stringutils::utf32_length_from_utf8(text), U'\0');
+        auto r16 = stringutils::utf8_to_utf16(text, &u16[0]);
+        auto r32 = stringutils::utf8_to_utf32(text, &u32[0]);
+        std::string back16(stringutils::utf8_length_from_utf16(u16), '\0');
+        std::string back32(stringutils::utf8_length_from_utf32(u32), '\0');
+        ok = ok && r16.ok() && r32.ok() && u32.size() == 27 && u16.size() == 28 && u32.back() == U'\U0001F44D' &&
+             stringutils::utf16_to_utf8(u16, &back16[0]).ok() && back16 == text &&
+             stringutils::utf32_to_utf8(u32, &back32[0]).ok() && back32 == text;
+
+        std::u16string lone = u"ab";
+        lone += static_cast<char16_t>(0xDC00);
+        char out[16];
+        auto broken = stringutils::utf8_to_utf32("ok\xc3(", &u32[0]);
+        ok = ok && broken.error == 2 && broken.written == 2 && stringutils::utf16_to_utf8(lone, out).error == 2;
+        std::cout << "utf8: " << text.size() << " bytes, " << u32.size() << " code points"
+                  << (ok ? "" : " (MISMATCH)") << "\n";
+        if (!ok) return 1;
+    }
+
+    // CSV: quoting across vector blocks, CRLF, the chunked reader with a
+    // buffer smaller than a record, and parallel parsing
+    {
+        std::string csv = "id,name,note\r\n"
+                          "1,plain,\"quoted, with comma\"\r\n"
+                          "\n"
+                          "2,\"say \"\"hi\"\"\",\"spans\nlines\"\n"
+                          "3,,\"\"\n";
+        for (int i = 0; i < 40; ++i) csv += std::to_string(4 + i) + ",padding padding padding," + std::string(i, 'x') + "\n";
+        csv += "last,no newline";
+
+        stringutils::CsvParser parser(csv);
+        stringutils::CsvRecord record;
+        std::vector<std::vector<std::string>> rows;
+        std::string scratch;
+        while (parser.next(record)) {
+            std::vector<std::string> row;
+            for (std::size_t i = 0; i < record.size(); ++i) row.emplace_back(record.unescaped(i, scratch));
+            rows.push_back(row);
+        }
+        bool ok = parser.error() == stringutils::CsvError::None && rows.size() == 45 &&
+                  rows[1] == std::vector<std::string>{"1", "plain", "quoted, with comma"} &&
+                  rows[2] == std::vector<std::string>{"2", "say \"hi\"", "spans\nlines"} &&
+                  rows[3] == std::vector<std::string>{"3", "", ""} && rows[44][1] == "no newline";
+
+        const char* tmp = std::getenv("TMPDIR");
+        const std::string path =
+            std::string(tmp ? tmp : "/tmp") + "/shared_lib_test_" + std::to_string(getpid()) + ".csv";
+        std::FILE* f = std::fopen(path.c_str(), "wb");
+        bool written = f && std::fwrite(csv.data(), 1, csv.size(), f) == csv.size();
+        if (f) written = std::fclose(f) == 0 && written;
+        if (!written) {
+            std::cout << "csv: cannot write " << path << "\n";
+            std::remove(path.c_str());
+            return 1;
+        }
+        stringutils::CsvReader reader(path, {}, 16);
+        std::size_t streamed = 0;
+        while (reader.next(record)) {
+            std::vector<std::string> row;
+            for (std::size_t i = 0; i < record.size(); ++i) row.emplace_back(record.unescaped(i, scratch));
+            ok = ok && streamed < rows.size() && row == rows[streamed++];
+        }
+        std::remove(path.c_str());
+        ok = ok && streamed == rows.size() && reader.error() == stringutils::CsvError::None;
+
+        std::string big;
+        for (int i = 0; i < 20000; ++i) big += std::to_string(i) + ",\"a\nb\",\"c,\"\"d\"\"\"\n";
+        std::vector<std::size_t> sums(4, 0);
+        auto status = stringutils::parse_csv_parallel(big, 4, [&](std::size_t chunk, const stringutils::CsvRecord& r) {
+            sums[chunk] += std::stoul(std::string(r[0])) + (r.size() == 3 && r[1] == "a\nb" ? 0 : 1000000);
+        });
+        std::size_t sum = 0;
+        for (auto s : sums) sum += s;
+        ok = ok && status.ok() && status.records == 20000 && sum == 19999u * 20000 / 2;
+
+        const char* malformed[] = {"a,\"open\n", "a,\"x\"y\n", "a,b\"c\"\n"};
+        const stringutils::CsvError expected[] = {stringutils::CsvError::UnterminatedQuote,
+                                                  stringutils::CsvError::TextAfterQuote,
+                                                  stringutils::CsvError::StrayQuote};
+        for (int i = 0; i < 3; ++i) {
+            std::string text = std::string("ok\n") + malformed[i];
+            stringutils::CsvParser bad(text);
+            ok = ok && bad.next(record) && !bad.next(record) && bad.error() == expected[i] && bad.error_offset() == 3;
+        }
+        std::cout << "csv: " << rows.size() << " records, " << status.records << " in parallel"
+                  << (ok ? "" : " (MISMATCH)") << "\n";
+        if (!ok) return 1;
+    }
+
     std::cout << "\nShared library test passed.\n";
     return 0;
 }
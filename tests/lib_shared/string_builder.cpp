@@ -0,0 +1,89 @@
+// String builder and arena implementation
+#include "string_builder.h"
+#include "numeric.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace stringutils {
+
+// ── Arena ───────────────────────────────────────────────────────────────────
+
+Arena::Arena(std::size_t block_size) : block_size_(block_size == 0 ? 1 : block_size) {}
+
+char* Arena::allocate(std::size_t n, std::size_t align) {
+    std::size_t pad = (align - reinterpret_cast<std::uintptr_t>(cursor_) % align) % align;
+    if (n + pad > remaining_) {
+        // Oversized requests get a block of their own size. new[] storage
+        // is aligned for any fundamental type, so no padding is needed.
+        std::size_t size = std::max(block_size_, n);
+        blocks_.emplace_back(new char[size]);
+        if (blocks_.size() == 1) first_block_size_ = size;
+        cursor_ = blocks_.back().get();
+        remaining_ = size;
+        pad = 0;
+    }
+    char* p = cursor_ + pad;
+    cursor_ = p + n;
+    remaining_ -= n + pad;
+    return p;
+}
+
+void Arena::reset() {
+    if (blocks_.empty()) return;
+    blocks_.resize(1);
+    cursor_ = blocks_.front().get();
+    remaining_ = first_block_size_;
+}
+
+// ── StringBuilder ───────────────────────────────────────────────────────────
+
+StringBuilder::~StringBuilder() {
+    if (heap_) delete[] data_;
+}
+
+void StringBuilder::reserve(std::size_t capacity) {
+    if (capacity <= capacity_) return;
+    char* fresh = arena_ ? arena_->allocate(capacity) : new char[capacity];
+    std::memcpy(fresh, data_, size_);
+    if (heap_) delete[] data_;
+    data_ = fresh;
+    capacity_ = capacity;
+    heap_ = arena_ == nullptr;
+}
+
+char* StringBuilder::grow_for(std::size_t extra) {
+    if (capacity_ - size_ < extra) reserve(std::max(capacity_ * 2, size_ + extra));
+    return data_ + size_;
+}
+
+StringBuilder& StringBuilder::append(std::string_view s) {
+    if (!s.empty()) {
+        std::memcpy(grow_for(s.size()), s.data(), s.size());
+        size_ += s.size();
+    }
+    return *this;
+}
+
+StringBuilder& StringBuilder::append(char c) {
+    *grow_for(1) = c;
+    ++size_;
+    return *this;
+}
+
+StringBuilder& StringBuilder::append_signed(long long v) {
+    char buf[kMaxNumberChars];
+    return append(std::string_view(buf, format_number(v, buf, sizeof(buf))));
+}
+
+StringBuilder& StringBuilder::append_unsigned(unsigned long long v) {
+    char buf[kMaxNumberChars];
+    return append(std::string_view(buf, format_number(v, buf, sizeof(buf))));
+}
+
+StringBuilder& StringBuilder::append(double v) {
+    char buf[kMaxNumberChars];
+    return append(std::string_view(buf, format_number(v, buf, sizeof(buf))));
+}
+
+}  // namespace stringutils
@@ -0,0 +1,104 @@
+// Shared library: allocation-light string building
+#ifndef STRING_BUILDER_H
+#define STRING_BUILDER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace stringutils {
+
+// Bump allocator for short-lived strings. Memory is handed out from large
+// blocks and only returned all at once by reset() or the destructor, so
+// building many strings costs one heap allocation per block, not per string.
+class Arena {
+public:
+    explicit Arena(std::size_t block_size = 64 * 1024);
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // `align` must be a power of two no larger than alignof(std::max_align_t).
+    char* allocate(std::size_t n, std::size_t align = 1);
+    // Frees every block but the first; pointers handed out become invalid.
+    void reset();
+
+    std::size_t block_count() const { return blocks_.size(); }
+
+private:
+    std::size_t block_size_;
+    std::size_t first_block_size_ = 0;
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    char* cursor_ = nullptr;
+    std::size_t remaining_ = 0;
+};
+
+// Appends strings, views, characters, integers and floating-point values
+// into a buffer that starts inline. Nothing is allocated until the
+// contents outgrow kInlineCapacity; past that the buffer grows
+// geometrically on the heap, or inside an Arena when one is given. str()
+// is then the only allocation needed to hand the result out as a
+// std::string.
+//
+// Numbers are formatted with std::to_chars (shortest round-trip form for
+// floating point where the library supports it), so output never depends
+// on the locale.
+class StringBuilder {
+public:
+    static constexpr std::size_t kInlineCapacity = 256;
+
+    StringBuilder() = default;
+    explicit StringBuilder(Arena& arena) : arena_(&arena) {}
+    ~StringBuilder();
+    StringBuilder(const StringBuilder&) = delete;
+    StringBuilder& operator=(const StringBuilder&) = delete;
+
+    StringBuilder& append(std::string_view s);
+    StringBuilder& append(const char* s) { return append(std::string_view(s)); }
+    StringBuilder& append(const std::string& s) { return append(std::string_view(s)); }
+    StringBuilder& append(char c);
+    StringBuilder& append(bool b) { return append(b ? std::string_view("true") : std::string_view("false")); }
+    StringBuilder& append(double v);
+    StringBuilder& append(float v) { return append(static_cast<double>(v)); }
+
+    template <typename T,
+              typename = std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, char> &&
+                                          !std::is_same_v<T, bool>>>
+    StringBuilder& append(T v) {
+        if constexpr (std::is_signed_v<T>) {
+            return append_signed(v);
+        } else {
+            return append_unsigned(v);
+        }
+    }
+
+    template <typename T>
+    StringBuilder& operator<<(const T& v) { return append(v); }
+
+    void reserve(std::size_t capacity);
+    void clear() { size_ = 0; }
+
+    std::size_t size() const { return size_; }
+    std::size_t capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+    std::string_view view() const { return {data_, size_}; }
+    std::string str() const { return std::string(data_, size_); }
+
+private:
+    StringBuilder& append_signed(long long v);
+    StringBuilder& append_unsigned(unsigned long long v);
+    char* grow_for(std::size_t extra);
+
+    char inline_[kInlineCapacity];
+    char* data_ = inline_;
+    std::size_t size_ = 0;
+    std::size_t capacity_ = kInlineCapacity;
+    Arena* arena_ = nullptr;
+    bool heap_ = false;  // data_ owned via new[] (never with an arena)
+};
+
+}  // namespace stringutils
+
+#endif  // STRING_BUILDER_H
@@ -1,47 +1,32 @@
 // Shared library implementation
 #include "stringutils.h"
 #include <algorithm>
-#include <sstream>
-#include <cctype>
+#include <stdexcept>
 
 namespace stringutils {
 
-std::string to_upper(const std::string& s) {
-    std::string result = s;
-    std::transform(result.begin(), result.end(), result.begin(),
-                   [](unsigned char c) { return std::toupper(c); });
-    return result;
-}
-
-std::string to_lower(const std::string& s) {
-    std::string result = s;
-    std::transform(result.begin(), result.end(), result.begin(),
-                   [](unsigned char c) { return std::tolower(c); });
-    return result;
-}
-
 std::string trim(const std::string& s) {
-    auto start = s.find_first_not_of(" \t\n\r");
-    if (start == std::string::npos) return "";
-    auto end = s.find_last_not_of(" \t\n\r");
-    return s.substr(start, end - start + 1);
+    return std::string(trim_view(s));
 }
 
 std::vector<std::string> split(const std::string& s, char delimiter) {
     std::vector<std::string> tokens;
-    std::istringstream stream(s);
-    std::string token;
-    while (std::getline(stream, token, delimiter)) {
-        tokens.push_back(token);
+    for (std::string_view token : split_view(s, delimiter)) {
+        tokens.emplace_back(token);
     }
     return tokens;
 }
 
 std::string join(const std::vector<std::string>& parts, const std::string& sep) {
-    std::string result;
+    if (parts.empty()) return {};
+    // Size the result exactly so it is allocated once.
+    std::size_t total = sep.size() * (parts.size() - 1);
+    for (const auto& p : parts) total += p.size();
+    std::string result(total, '\0');
+    char* out = &result[0];
     for (size_t i = 0; i < parts.size(); ++i) {
-        if (i > 0) result += sep;
-        result += parts[i];
+        if (i > 0) out = std::copy(sep.begin(), sep.end(), out);
+        out = std::copy(parts[i].begin(), parts[i].end(), out);
     }
     return result;
 }
@@ -51,13 +36,49 @@ bool contains(const std::string& haystack, const std::string& needle) {
 }
 
 std::string replace_all(const std::string& s, const std::string& from, const std::string& to) {
-    std::string result = s;
-    size_t pos = 0;
-    while ((pos = result.find(from, pos)) != std::string::npos) {
-        result.replace(pos, from.length(), to);
-        pos += to.length();
+    if (from.empty()) return s;
+    // Build the result front to back; replacing in place would shift the
+    // tail on every match when from and to differ in length.
+    std::string result;
+    std::size_t pos = s.find(from);
+    if (pos == std::string::npos) return s;
+    result.reserve(to.size() > from.size() ? s.size() + (to.size() - from.size()) * 4 : s.size());
+    std::size_t run = 0;
+    while (pos != std::string::npos) {
+        result.append(s, run, pos - run);
+        result += to;
+        run = pos + from.size();
+        pos = s.find(from, run);
     }
+    result.append(s, run, std::string::npos);
     return result;
 }
 
+std::string_view trim_view(std::string_view s) {
+    auto start = s.find_first_not_of(" \t\n\r");
+    if (start == std::string_view::npos) return {};
+    auto end = s.find_last_not_of(" \t\n\r");
+    return s.substr(start, end - start + 1);
+}
+
+SplitView::SplitView(std::string_view source, std::string_view delimiter, std::size_t max_splits)
+    : source_(source), delimiter_(delimiter), delimiter_size_(delimiter.size()), max_splits_(max_splits) {
+    if (delimiter.empty()) throw std::invalid_argument("empty delimiter");
+    if (delimiter.size() == 1) {
+        single_ = true;
+        single_char_ = delimiter[0];
+    }
+}
+
+SplitView::SplitView(std::string_view source, char delimiter, std::size_t max_splits)
+    : source_(source), delimiter_size_(1), max_splits_(max_splits), single_char_(delimiter), single_(true) {}
+
+SplitView split_view(std::string_view s, char delimiter, std::size_t max_splits) {
+    return SplitView(s, delimiter, max_splits);
+}
+
+SplitView split_view(std::string_view s, std::string_view delimiter, std::size_t max_splits) {
+    return SplitView(s, delimiter, max_splits);
+}
+
 }  // namespace stringutils
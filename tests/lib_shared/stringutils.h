@@ -2,11 +2,16 @@
 #ifndef STRINGUTILS_H
 #define STRINGUTILS_H
 
+#include <cstddef>
+#include <iterator>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace stringutils {
 
+// Case conversion is ASCII-only and locale-independent (the "C" locale
+// behaviour): bytes outside 'a'-'z' / 'A'-'Z' are copied unchanged.
 std::string to_upper(const std::string& s);
 std::string to_lower(const std::string& s);
 std::string trim(const std::string& s);
@@ -15,6 +20,115 @@ std::string join(const std::vector<std::string>& parts, const std::string& sep);
 bool contains(const std::string& haystack, const std::string& needle);
 std::string replace_all(const std::string& s, const std::string& from, const std::string& to);
 
+// ── Non-allocating string_view variants ─────────────────────────────────────
+// Write in.size() bytes to out (which may alias in.data()).
+void to_upper(std::string_view in, char* out);
+void to_lower(std::string_view in, char* out);
+void to_upper_inplace(char* s, std::size_t n);
+void to_lower_inplace(char* s, std::size_t n);
+void to_upper_inplace(std::string& s);
+void to_lower_inplace(std::string& s);
+
+std::string_view trim_view(std::string_view s);
+
+inline bool starts_with(std::string_view s, std::string_view prefix) {
+    return s.size() >= prefix.size() && s.compare(0, prefix.size(), prefix) == 0;
+}
+
+inline bool ends_with(std::string_view s, std::string_view suffix) {
+    return s.size() >= suffix.size() &&
+           s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Lazy split: iterating yields views into the source, nothing is copied or
+// allocated. Tokens match split(): an empty input yields no tokens and a
+// trailing empty token is dropped. After max_splits delimiters the rest of
+// the input, delimiters included, is the final token.
+class SplitView {
+public:
+    static constexpr std::size_t unlimited = static_cast<std::size_t>(-1);
+
+    SplitView(std::string_view source, std::string_view delimiter, std::size_t max_splits = unlimited);
+    SplitView(std::string_view source, char delimiter, std::size_t max_splits = unlimited);
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        iterator() = default;
+        reference operator*() const { return token_; }
+        pointer operator->() const { return &token_; }
+        iterator& operator++() {
+            advance();
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator tmp = *this;
+            advance();
+            return tmp;
+        }
+        bool operator==(const iterator& o) const { return view_ == o.view_ && pos_ == o.pos_; }
+        bool operator!=(const iterator& o) const { return !(*this == o); }
+
+    private:
+        friend class SplitView;
+        static constexpr std::size_t end_pos = static_cast<std::size_t>(-1);
+
+        iterator(const SplitView* view, std::size_t pos) : view_(view), pos_(pos), splits_(0) {
+            if (pos_ != end_pos) advance();
+        }
+        void advance();
+
+        const SplitView* view_ = nullptr;
+        std::size_t pos_ = end_pos;   // start of the next token; end_pos when done
+        std::size_t splits_ = 0;
+        std::string_view token_;
+    };
+
+    iterator begin() const { return iterator(this, source_.empty() ? iterator::end_pos : 0); }
+    iterator end() const { return iterator(this, iterator::end_pos); }
+
+    // Materializes the tokens (still views into the source).
+    std::vector<std::string_view> to_vector() const { return {begin(), end()}; }
+
+private:
+    std::string_view source_;
+    std::string_view delimiter_;  // unused when single_
+    std::size_t delimiter_size_;
+    std::size_t max_splits_;
+    char single_char_ = '\0';     // stored by value so copies stay valid
+    bool single_ = false;
+};
+
+inline void SplitView::iterator::advance() {
+    const std::string_view src = view_->source_;
+    if (pos_ == end_pos) return;
+    if (pos_ >= src.size()) {
+        // Reached only after a trailing delimiter: drop the empty token.
+        pos_ = end_pos;
+        return;
+    }
+    std::size_t hit = std::string_view::npos;
+    if (splits_ < view_->max_splits_) {
+        hit = view_->single_ ? src.find(view_->single_char_, pos_) : src.find(view_->delimiter_, pos_);
+    }
+    if (hit == std::string_view::npos) {
+        token_ = src.substr(pos_);
+        pos_ = src.size() + 1;  // past the end: the next advance() finishes
+    } else {
+        token_ = src.substr(pos_, hit - pos_);
+        pos_ = hit + view_->delimiter_size_;
+        ++splits_;
+    }
+}
+
+SplitView split_view(std::string_view s, char delimiter, std::size_t max_splits = SplitView::unlimited);
+SplitView split_view(std::string_view s, std::string_view delimiter, std::size_t max_splits = SplitView::unlimited);
+
 }  // namespace stringutils
 
 #endif  // STRINGUTILS_H
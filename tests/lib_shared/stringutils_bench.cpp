@@ -0,0 +1,502 @@
+// Throughput benchmarks for stringutils
+//
+// Usage: stringutils_bench [input_megabytes]   (default 4)
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <sys/resource.h>
+#include <unordered_map>
+#include "stringutils.h"
+#include "csv.h"
+#include "intern_pool.h"
+#include "numeric.h"
+#include "replacer.h"
+#include "searcher.h"
+#include "string_builder.h"
+#include "utf8.h"
+
+namespace {
+
+// Runs fn in growing batches until one batch takes at least ~100 ms and
+// returns ns per call; batching keeps clock reads out of short timings.
+template <typename Fn>
+double time_ns(Fn&& fn) {
+    using clock = std::chrono::steady_clock;
+    for (std::size_t batch = 1;; batch *= 2) {
+        auto start = clock::now();
+        for (std::size_t i = 0; i < batch; ++i) fn();
+        auto elapsed = clock::now() - start;
+        if (elapsed >= std::chrono::milliseconds(100)) {
+            return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(batch);
+        }
+    }
+}
+
+// Log-like lines of comma-separated fields with padding to trim.
+std::string make_input(std::size_t bytes) {
+    std::mt19937 rng(1);
+    const char* words[] = {"sensor", " temp ", "42.5", "OK", "  qnx-node-07", "timeout ", "0x1f"};
+    std::string s;
+    s.reserve(bytes + 64);
+    while (s.size() < bytes) {
+        int fields = 4 + static_cast<int>(rng() % 8);
+        for (int f = 0; f < fields; ++f) {
+            if (f) s += ',';
+            s += words[rng() % 7];
+        }
+        s += '\n';
+    }
+    return s;
+}
+
+// The previous istringstream-based split, kept as the baseline.
+std::vector<std::string> stream_split(const std::string& s, char delimiter) {
+    std::vector<std::string> tokens;
+    std::istringstream stream(s);
+    std::string token;
+    while (std::getline(stream, token, delimiter)) tokens.push_back(token);
+    return tokens;
+}
+
+// The previous in-place replace_all, kept as the baseline.
+std::string inplace_replace_all(const std::string& s, const std::string& from, const std::string& to) {
+    std::string result = s;
+    std::size_t pos = 0;
+    while ((pos = result.find(from, pos)) != std::string::npos) {
+        result.replace(pos, from.length(), to);
+        pos += to.length();
+    }
+    return result;
+}
+
+// Byte-at-a-time validation as application code usually writes it.
+bool naive_valid_utf8(const std::string& s) {
+    std::size_t i = 0;
+    while (i < s.size()) {
+        auto c = static_cast<unsigned char>(s[i]);
+        std::size_t len = c < 0x80 ? 1 : (c >> 5) == 6 ? 2 : (c >> 4) == 14 ? 3 : (c >> 3) == 30 ? 4 : 0;
+        if (len == 0 || i + len > s.size()) return false;
+        std::uint32_t cp = len == 1 ? c : c & (0x7F >> len);
+        for (std::size_t k = 1; k < len; ++k) {
+            auto d = static_cast<unsigned char>(s[i + k]);
+            if ((d & 0xC0) != 0x80) return false;
+            cp = (cp << 6) | (d & 0x3F);
+        }
+        static const std::uint32_t min_cp[] = {0, 0, 0x80, 0x800, 0x10000};
+        if (cp < min_cp[len] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return false;
+        i += len;
+    }
+    return true;
+}
+
+void report(const char* name, double ns, std::size_t bytes) {
+    std::cout << "  " << std::left << std::setw(28) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(9) << ns / 1e6 << " ms  "
+              << std::setw(7) << static_cast<double>(bytes) / ns << " GB/s\n";
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::setprecision(6);
+}
+
+volatile std::size_t g_sink;
+
+// Peak resident set size so far, in KB (0 where the OS does not report it).
+long peak_rss_kb() {
+    struct rusage ru;
+    return getrusage(RUSAGE_SELF, &ru) == 0 ? ru.ru_maxrss : 0;
+}
+
+// Runs first, before the in-memory inputs grow the peak RSS. Each reader
+// takes one pass over the same file and sums field lengths; the getline
+// loop does not understand quoting, so its field count differs.
+void bench_csv(std::size_t bytes) {
+    const char* tmp = std::getenv("TMPDIR");
+    std::string path = std::string(tmp ? tmp : "/tmp") + "/stringutils_bench.csv";
+    std::size_t records = 0;
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        std::mt19937 rng(17);
+        const char* names[] = {"sensor", "qnx-node-07", "\"Smith, J.\"", "\"said \"\"ok\"\"\"", "timeout"};
+        std::string block;
+        for (std::size_t written = 0; written < bytes; written += block.size()) {
+            block.clear();
+            while (block.size() < (1 << 16)) {
+                block += std::to_string(rng() % 100000) + ',' + names[rng() % 5] + ",42.5," +
+                         std::to_string(rng() % 1000) + ",OK\n";
+                ++records;
+            }
+            out.write(block.data(), static_cast<std::streamsize>(block.size()));
+        }
+    }
+    std::cout << "\n--- CSV, " << records << " records ---\n";
+
+    using clock = std::chrono::steady_clock;
+    auto run = [&](const char* name, auto&& parse) {
+        long rss_before = peak_rss_kb();
+        auto t0 = clock::now();
+        std::size_t n = parse();
+        double s = std::chrono::duration<double>(clock::now() - t0).count();
+        std::cout << "  " << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(9) << s * 1e3 << " ms  " << std::setw(7) << static_cast<double>(n) / s / 1e6
+                  << " M rec/s  peak RSS +" << peak_rss_kb() - rss_before << " KB\n";
+        std::cout.unsetf(std::ios::fixed);
+        std::cout << std::setprecision(6);
+    };
+
+    run("CsvReader (1 MB buffer)", [&] {
+        stringutils::CsvReader reader(path);
+        stringutils::CsvRecord record;
+        std::size_t n = 0, sum = 0;
+        for (; reader.next(record); ++n)
+            for (auto field : record) sum += field.size();
+        g_sink = sum;
+        return n;
+    });
+    run("getline + split", [&] {
+        std::ifstream in(path);
+        std::string line;
+        std::size_t n = 0, sum = 0;
+        for (; std::getline(in, line); ++n)
+            for (const auto& field : stringutils::split(line, ',')) sum += field.size();
+        g_sink = sum;
+        return n;
+    });
+    run("mmap + CsvParser", [&] {
+        stringutils::MappedFile file(path);
+        stringutils::CsvParser parser(file.view());
+        stringutils::CsvRecord record;
+        std::size_t n = 0, sum = 0;
+        for (; parser.next(record); ++n)
+            for (auto field : record) sum += field.size();
+        g_sink = sum;
+        return n;
+    });
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string parallel_name = "mmap + parallel (" + std::to_string(threads) + " threads)";
+    run(parallel_name.c_str(), [&] {
+        stringutils::MappedFile file(path);
+        std::vector<std::size_t> sums(threads);
+        auto status = stringutils::parse_csv_parallel(file.view(), threads,
+                                                      [&](std::size_t chunk, const stringutils::CsvRecord& r) {
+            for (auto field : r) sums[chunk] += field.size();
+        });
+        g_sink = sums[0];
+        return status.records;
+    });
+    std::remove(path.c_str());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::size_t mb = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4;
+    std::cout << "=== stringutils benchmark ===\n";
+    bench_csv((mb << 20) * 4);
+    std::string input = make_input(mb << 20);
+    std::cout << "\n=== " << input.size() << " byte inputs ===\n";
+
+    // ── split / trim ────────────────────────────────────────────────────────
+    std::cout << "\n--- split lines, then fields, then trim ---\n";
+    report("istringstream split + trim", time_ns([&] {
+        std::size_t n = 0;
+        for (const auto& line : stream_split(input, '\n'))
+            for (const auto& field : stream_split(line, ',')) n += stringutils::trim(field).size();
+        g_sink = n;
+    }), input.size());
+    report("split + trim", time_ns([&] {
+        std::size_t n = 0;
+        for (const auto& line : stringutils::split(input, '\n'))
+            for (const auto& field : stringutils::split(line, ',')) n += stringutils::trim(field).size();
+        g_sink = n;
+    }), input.size());
+    report("split_view + trim_view", time_ns([&] {
+        std::size_t n = 0;
+        for (auto line : stringutils::split_view(input, '\n'))
+            for (auto field : stringutils::split_view(line, ',')) n += stringutils::trim_view(field).size();
+        g_sink = n;
+    }), input.size());
+
+    // ── case conversion ─────────────────────────────────────────────────────
+    std::cout << "\n--- to_upper (GB/s) ---\n";
+    for (std::size_t len : {16u, 256u, 4096u, 1u << 20}) {
+        std::string text = input.substr(0, len);
+        std::string out(len, '\0');
+        double t_toupper = time_ns([&] {
+            std::string r = text;
+            for (auto& c : r) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            g_sink = static_cast<unsigned char>(r[len / 2]);
+        });
+        double t_copy = time_ns([&] { g_sink = static_cast<unsigned char>(stringutils::to_upper(text)[len / 2]); });
+        double t_buffer = time_ns([&] {
+            stringutils::to_upper(text, &out[0]);
+            g_sink = static_cast<unsigned char>(out[len / 2]);
+        });
+        double t_inplace = time_ns([&] {
+            stringutils::to_upper_inplace(out);
+            g_sink = static_cast<unsigned char>(out[len / 2]);
+        });
+        std::cout << "  " << std::setw(8) << len << " bytes: std::toupper " << std::fixed << std::setprecision(2)
+                  << len / t_toupper << "  to_upper " << len / t_copy << "  into buffer " << len / t_buffer
+                  << "  in place " << len / t_inplace << "\n";
+        std::cout.unsetf(std::ios::fixed);
+    }
+
+    // ── multi-pattern replace ───────────────────────────────────────────────
+    std::cout << "\n--- sanitize with 24 rules ---\n";
+    {
+        std::vector<std::pair<std::string, std::string>> rules = {
+            {"<", "&lt;"}, {">", "&gt;"}, {"&", "&amp;"}, {"\"", "&quot;"}, {"'", "&#39;"},
+            {"sensor", "S"}, {"timeout", "TO"}, {"qnx-node", "node"}, {"0x", "hex:"}, {"OK", "ok"},
+            {"42.5", "42.50"}, {"temp", "temperature"}, {",", ";"}, {"\t", " "}, {"  ", " "},
+            {"password", "***"}, {"secret", "***"}, {"token", "***"}, {"ERROR", "E"}, {"WARN", "W"},
+            {"INFO", "I"}, {"DEBUG", "D"}, {"\r\n", "\n"}, {"-07", "-7"}};
+        stringutils::Replacer replacer(rules);
+        // The old version is quadratic; only time it on small inputs.
+        if (input.size() <= (4u << 20)) {
+            report("chained replace_all (old)", time_ns([&] {
+                std::string r = input;
+                for (const auto& rule : rules) r = inplace_replace_all(r, rule.first, rule.second);
+                g_sink = r.size();
+            }), input.size());
+        }
+        report("chained replace_all", time_ns([&] {
+            std::string r = input;
+            for (const auto& rule : rules) r = stringutils::replace_all(r, rule.first, rule.second);
+            g_sink = r.size();
+        }), input.size());
+        std::string out;
+        report("Replacer::apply", time_ns([&] {
+            replacer.apply(input, out);
+            g_sink = out.size();
+        }), input.size());
+    }
+
+    // ── substring search ────────────────────────────────────────────────────
+    // '|' never occurs in the input, so every needle but the one-byte case
+    // starts with a common byte and forces a full scan.
+    std::cout << "\n--- absent needle, full scan (GB/s) ---\n";
+    {
+        const std::string base = "s|sensor,temp|42.5,OK|qnx-node-07,timeout|0x1f,sensor|temp,OK,timeout|0x";
+        for (std::size_t len : {1u, 2u, 4u, 8u, 16u, 32u, 48u, 64u}) {
+            const std::string needle = len == 1 ? "|" : base.substr(0, len);
+            stringutils::Searcher searcher(needle);
+            double t_contains = time_ns([&] { g_sink = stringutils::contains(input, needle); });
+            double t_searcher = time_ns([&] { g_sink = searcher.contains(input); });
+            std::cout << "  needle " << std::setw(2) << len << ": contains " << std::fixed << std::setprecision(2)
+                      << input.size() / t_contains << "  Searcher " << input.size() / t_searcher << "\n";
+            std::cout.unsetf(std::ios::fixed);
+        }
+    }
+    std::cout << "\n--- all offsets of \"qnx-node\" ---\n";
+    {
+        const std::string needle = "qnx-node";
+        stringutils::Searcher searcher(needle);
+        std::vector<std::size_t> hits;
+        report("std::string::find loop", time_ns([&] {
+            hits.clear();
+            for (auto p = input.find(needle); p != std::string::npos; p = input.find(needle, p + needle.size()))
+                hits.push_back(p);
+            g_sink = hits.size();
+        }), input.size());
+        report("Searcher::find_all", time_ns([&] {
+            hits.clear();
+            g_sink = searcher.find_all(input, hits);
+        }), input.size());
+    }
+
+    // ── building strings ────────────────────────────────────────────────────
+    std::cout << "\n--- join 1000 fields, build log lines ---\n";
+    {
+        std::vector<std::string> fields;
+        for (auto field : stringutils::split_view(input.substr(0, 64 * 1024), ',')) {
+            if (fields.size() == 1000) break;
+            fields.emplace_back(field);
+        }
+        double t_grow = time_ns([&] {
+            std::string r;
+            for (std::size_t i = 0; i < fields.size(); ++i) {
+                if (i > 0) r += ", ";
+                r += fields[i];
+            }
+            g_sink = r.size();
+        });
+        double t_join = time_ns([&] { g_sink = stringutils::join(fields, ", ").size(); });
+        std::cout << "  join: += " << t_grow << " ns  presized " << t_join << " ns\n";
+
+        const std::string key = "sample_rate", value = "48000";
+        double t_concat = time_ns([&] { g_sink = ("Config set: " + key + " = " + value + " (" + std::to_string(42) + ")").size(); });
+        double t_builder = time_ns([&] {
+            stringutils::StringBuilder sb;
+            sb << "Config set: " << key << " = " << value << " (" << 42 << ')';
+            g_sink = sb.str().size();
+        });
+        stringutils::Arena arena;
+        double t_arena = time_ns([&] {
+            stringutils::StringBuilder sb(arena);
+            sb << "Config set: " << key << " = " << value << " (" << 42 << ')';
+            g_sink = sb.view().size();
+        });
+        std::cout << "  log line: operator+ " << t_concat << " ns  builder+str() " << t_builder
+                  << " ns  builder view " << t_arena << " ns\n";
+    }
+
+    // ── number parsing ──────────────────────────────────────────────────────
+    std::cout << "\n--- parse a column of 1M numbers ---\n";
+    {
+        const std::size_t count = 1000000;
+        std::mt19937 rng(5);
+        std::string ints, doubles;
+        char buf[stringutils::kMaxNumberChars];
+        for (std::size_t i = 0; i < count; ++i) {
+            ints.append(buf, stringutils::format_number(static_cast<int>(rng() % 100000), buf, sizeof(buf)));
+            ints += '\n';
+            double v = static_cast<double>(static_cast<int>(rng() % 2000000) - 1000000) / 1000.0;
+            doubles.append(buf, stringutils::format_number(v, buf, sizeof(buf)));
+            doubles += '\n';
+        }
+        std::vector<int> int_out(count);
+        std::vector<double> double_out(count);
+
+        report("int: std::stoi", time_ns([&] {
+            std::size_t n = 0;
+            for (auto field : stringutils::split_view(ints, '\n')) int_out[n++] = std::stoi(std::string(field));
+            g_sink = n;
+        }), ints.size());
+        report("int: istringstream >>", time_ns([&] {
+            std::istringstream in(ints);
+            std::size_t n = 0;
+            while (n < count && in >> int_out[n]) ++n;
+            g_sink = n;
+        }), ints.size());
+        report("int: parse_column", time_ns([&] {
+            g_sink = stringutils::parse_column(ints, '\n', int_out.data(), count).count;
+        }), ints.size());
+
+        report("double: std::stod", time_ns([&] {
+            std::size_t n = 0;
+            for (auto field : stringutils::split_view(doubles, '\n')) double_out[n++] = std::stod(std::string(field));
+            g_sink = n;
+        }), doubles.size());
+        report("double: istringstream >>", time_ns([&] {
+            std::istringstream in(doubles);
+            std::size_t n = 0;
+            while (n < count && in >> double_out[n]) ++n;
+            g_sink = n;
+        }), doubles.size());
+        report("double: parse_column", time_ns([&] {
+            g_sink = stringutils::parse_column(doubles, '\n', double_out.data(), count).count;
+        }), doubles.size());
+
+        std::string text;
+        report("double: format_number", time_ns([&] {
+            text.clear();
+            for (double v : double_out) {
+                text.append(buf, stringutils::format_number(v, buf, sizeof(buf)));
+                text += '\n';
+            }
+            g_sink = text.size();
+        }), doubles.size());
+        report("double: ostringstream <<", time_ns([&] {
+            std::ostringstream out;
+            out.precision(17);
+            for (double v : double_out) out << v << '\n';
+            g_sink = out.str().size();
+        }), doubles.size());
+    }
+
+    // ── interning ───────────────────────────────────────────────────────────
+    std::cout << "\n--- 1M references to 2000 distinct keys ---\n";
+    {
+        const std::size_t refs = 1000000, distinct = 2000;
+        std::mt19937 rng(11);
+        std::vector<std::string> keys;
+        keys.reserve(refs);
+        for (std::size_t i = 0; i < refs; ++i) keys.push_back("events/sensor/channel-" + std::to_string(rng() % distinct));
+
+        stringutils::InternPool pool;
+        std::vector<stringutils::InternPool::Id> ids;
+        ids.reserve(refs);
+        for (const auto& k : keys) ids.push_back(pool.intern(k));
+
+        std::size_t string_bytes = refs * sizeof(std::string);
+        for (const auto& k : keys) string_bytes += k.capacity() + 1;  // heap part, malloc overhead ignored
+        std::size_t id_bytes = refs * sizeof(stringutils::InternPool::Id) + pool.memory_bytes();
+        std::cout << "  memory: std::string copies " << string_bytes / 1024 << " KiB  IDs + pool "
+                  << id_bytes / 1024 << " KiB\n";
+
+        // Keys as they arrive: views into one buffer, e.g. parsed log lines.
+        // Without heterogeneous lookup (C++20) the map needs a std::string.
+        std::string stream;
+        for (const auto& k : keys) (stream += k) += '\n';
+        std::unordered_map<std::string, int> table;
+        for (const auto& k : keys) table.emplace(k, static_cast<int>(table.size()));
+        double t_map = time_ns([&] {
+            std::size_t n = 0;
+            for (auto k : stringutils::split_view(stream, '\n'))
+                n += static_cast<std::size_t>(table.find(std::string(k))->second);
+            g_sink = n;
+        });
+        double t_pool = time_ns([&] {
+            std::size_t n = 0;
+            for (auto k : stringutils::split_view(stream, '\n')) n += pool.find(k);
+            g_sink = n;
+        });
+        double t_str_eq = time_ns([&] {
+            std::size_t n = 0;
+            for (std::size_t i = 1; i < refs; ++i) n += keys[i] == keys[i - 1];
+            g_sink = n;
+        });
+        double t_id_eq = time_ns([&] {
+            std::size_t n = 0;
+            for (std::size_t i = 1; i < refs; ++i) n += ids[i] == ids[i - 1];
+            g_sink = n;
+        });
+        std::cout << "  lookup: unordered_map " << t_map / refs << " ns  InternPool::find " << t_pool / refs
+                  << " ns\n  equality: std::string " << t_str_eq / refs << " ns  Id " << t_id_eq / refs << " ns\n";
+    }
+
+    // ── UTF-8 ───────────────────────────────────────────────────────────────
+    {
+        std::string multilingual;
+        const char* samples[] = {"\xd0\xa2\xd0\xb5\xd0\xbc\xd0\xbf\xd0\xb5\xd1\x80\xd0\xb0\xd1\x82\xd1\x83\xd1\x80\xd0\xb0 ",
+                                 "\xe6\xb8\xa9\xe5\xba\xa6\xe4\xbc\xa0\xe6\x84\x9f\xe5\x99\xa8 ",
+                                 "\xce\xb8\xce\xb5\xcf\x81\xce\xbc\xce\xbf\xce\xba\xcf\x81\xce\xb1\xcf\x83\xce\xaf\xce\xb1 ",
+                                 "caf\xc3\xa9 na\xc3\xafve ", "\xf0\x9f\x8c\xa1\xef\xb8\x8f 21.5 ", "sensor=ok "};
+        std::mt19937 rng(13);
+        while (multilingual.size() < input.size()) multilingual += samples[rng() % 6];
+        std::vector<char16_t> u16(input.size());
+        std::vector<char32_t> u32(input.size());
+        std::vector<char> u8(input.size() + 4);
+        for (const auto* corpus : {&input, &multilingual}) {
+            const std::string& text = *corpus;
+            std::cout << "\n--- UTF-8, " << (corpus == &input ? "ASCII-heavy" : "multilingual") << " (GB/s of UTF-8) ---\n";
+            report("validate: byte at a time", time_ns([&] { g_sink = naive_valid_utf8(text); }), text.size());
+            report("validate: is_valid_utf8", time_ns([&] { g_sink = stringutils::is_valid_utf8(text); }), text.size());
+            auto n16 = stringutils::utf8_to_utf16(text, u16.data()).written;
+            auto n32 = stringutils::utf8_to_utf32(text, u32.data()).written;
+            report("utf8_to_utf16", time_ns([&] { g_sink = stringutils::utf8_to_utf16(text, u16.data()).written; }),
+                   text.size());
+            report("utf8_to_utf32", time_ns([&] { g_sink = stringutils::utf8_to_utf32(text, u32.data()).written; }),
+                   text.size());
+            report("utf16_to_utf8", time_ns([&] {
+                g_sink = stringutils::utf16_to_utf8({u16.data(), n16}, u8.data()).written;
+            }), text.size());
+            report("utf32_to_utf8", time_ns([&] {
+                g_sink = stringutils::utf32_to_utf8({u32.data(), n32}, u8.data()).written;
+            }), text.size());
+        }
+    }
+
+    std::cout << "\nstringutils benchmark done.\n";
+    return 0;
+}
@@ -0,0 +1,584 @@
+// UTF-8 validation and transcoding
+//
+// The vector validator is the lookup-table algorithm of Keiser and Lemire
+// ("Validating UTF-8 in less than one instruction per byte", 2021). Each
+// byte is classified together with its predecessor by three 16-entry
+// nibble tables (pshufb / tbl); any error class present in all three
+// lookups is a violation. Continuation bytes required by 3- and 4-byte
+// leads two and three positions back are checked separately, and a lead
+// at the very end of a block is carried into the next one. All-ASCII
+// blocks skip the tables entirely.
+//
+// The vector code only says which block went wrong; the exact offset comes
+// from rescanning with the scalar decoder from the last character boundary
+// before that block.
+#include "utf8.h"
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace stringutils {
+
+namespace {
+
+using u8 = std::uint8_t;
+
+// ── Scalar decoding ─────────────────────────────────────────────────────────
+
+// Length of the valid sequence starting at s[i] (storing its code point),
+// or 0 if the bytes there are not a complete well-formed sequence.
+inline std::size_t decode(const u8* s, std::size_t n, std::size_t i, char32_t& cp) {
+    const u8 c = s[i];
+    if (c < 0x80) {
+        cp = c;
+        return 1;
+    }
+    std::size_t len;
+    u8 lo = 0x80, hi = 0xBF;  // allowed range of the second byte
+    if (c >= 0xC2 && c <= 0xDF) {
+        len = 2;
+        cp = c & 0x1F;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        len = 3;
+        cp = c & 0x0F;
+        if (c == 0xE0) lo = 0xA0;          // overlong
+        else if (c == 0xED) hi = 0x9F;     // surrogates
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        len = 4;
+        cp = c & 0x07;
+        if (c == 0xF0) lo = 0x90;          // overlong
+        else if (c == 0xF4) hi = 0x8F;     // above U+10FFFF
+    } else {
+        return 0;
+    }
+    if (n - i < len || s[i + 1] < lo || s[i + 1] > hi) return 0;
+    cp = (cp << 6) | (s[i + 1] & 0x3F);
+    for (std::size_t k = 2; k < len; ++k) {
+        if ((s[i + k] & 0xC0) != 0x80) return 0;
+        cp = (cp << 6) | (s[i + k] & 0x3F);
+    }
+    return len;
+}
+
+inline bool ascii_word(const u8* p) {
+    std::uint64_t w;
+    std::memcpy(&w, p, sizeof(w));
+    return (w & 0x8080808080808080ULL) == 0;
+}
+
+std::size_t scalar_find_invalid(const u8* s, std::size_t n, std::size_t i) {
+    while (i < n) {
+        if (i + 8 <= n && ascii_word(s + i)) {
+            i += 8;
+            continue;
+        }
+        char32_t cp;
+        std::size_t len = decode(s, n, i, cp);
+        if (len == 0) return i;
+        i += len;
+    }
+    return kUtfNpos;
+}
+
+// Restart point for the exact rescan: the start of the last character
+// beginning before `block`. Everything before it was already validated.
+std::size_t boundary_before(const u8* s, std::size_t block) {
+    for (std::size_t back = 1; back <= 3 && back <= block; ++back) {
+        if ((s[block - back] & 0xC0) != 0x80) return block - back;
+    }
+    return block;
+}
+
+// ── Vector validation ───────────────────────────────────────────────────────
+
+// Error classes; a byte pair is invalid iff all three lookups share a bit.
+constexpr u8 kTooShort = 1 << 0;     // lead followed by a non-continuation
+constexpr u8 kTooLong = 1 << 1;      // ASCII followed by a continuation
+constexpr u8 kOverlong3 = 1 << 2;    // E0 80..9F
+constexpr u8 kTooLarge = 1 << 3;     // F4 90..BF, F5..FF
+constexpr u8 kSurrogate = 1 << 4;    // ED A0..BF
+constexpr u8 kOverlong2 = 1 << 5;    // C0..C1
+constexpr u8 kTooLarge1000 = 1 << 6; // F5..FF 80..8F
+constexpr u8 kOverlong4 = 1 << 6;    // F0 80..8F
+constexpr u8 kTwoConts = 1 << 7;     // continuation after continuation
+constexpr u8 kCarry = kTooShort | kTooLong | kTwoConts;
+
+// Indexed by the high nibble of the previous byte.
+constexpr u8 kByte1High[16] = {
+    kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+    kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+    kTooShort | kOverlong2,
+    kTooShort,
+    kTooShort | kOverlong3 | kSurrogate,
+    kTooShort | kTooLarge | kTooLarge1000 | kOverlong4,
+};
+// Indexed by the low nibble of the previous byte.
+constexpr u8 kByte1Low[16] = {
+    kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+    kCarry | kOverlong2,
+    kCarry,
+    kCarry,
+    kCarry | kTooLarge,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+};
+// Indexed by the high nibble of the current byte.
+constexpr u8 kByte2High[16] = {
+    kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooShort, kTooShort, kTooShort, kTooShort,
+};
+
+#if defined(__x86_64__)
+__attribute__((target("avx2")))
+inline __m256i avx2_table(const u8 (&t)[16]) {
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(t)));
+}
+
+// Returns the offset of the first 32-byte block with an error, or kUtfNpos.
+__attribute__((target("avx2")))
+std::size_t avx2_first_bad_block(const u8* s, std::size_t n) {
+    const __m256i t1h = avx2_table(kByte1High);
+    const __m256i t1l = avx2_table(kByte1Low);
+    const __m256i t2h = avx2_table(kByte2High);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i third_lead = _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80));
+    const __m256i fourth_lead = _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80));
+    const __m256i high_bit = _mm256_set1_epi8(static_cast<char>(0x80));
+    // Saturating input - max leaves a non-zero byte where a lead needs more
+    // bytes than the block has left.
+    const __m256i incomplete_max = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+
+    __m256i prev_input = _mm256_setzero_si256();
+    __m256i prev_incomplete = _mm256_setzero_si256();
+    std::size_t result = kUtfNpos;
+    alignas(32) u8 tail[32];
+
+    for (std::size_t i = 0; i <= n; i += 32) {
+        __m256i in;
+        if (i + 32 <= n) {
+            in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        } else {
+            // Zero padding is ASCII, so a truncated final sequence shows up
+            // as kTooShort or via prev_incomplete.
+            std::memset(tail, 0, sizeof(tail));
+            std::memcpy(tail, s + i, n - i);
+            in = _mm256_load_si256(reinterpret_cast<const __m256i*>(tail));
+        }
+        __m256i error;
+        if (_mm256_movemask_epi8(in) == 0) {
+            error = prev_incomplete;
+            prev_incomplete = _mm256_setzero_si256();
+        } else {
+            __m256i shifted = _mm256_permute2x128_si256(prev_input, in, 0x21);
+            __m256i prev1 = _mm256_alignr_epi8(in, shifted, 15);
+            __m256i prev2 = _mm256_alignr_epi8(in, shifted, 14);
+            __m256i prev3 = _mm256_alignr_epi8(in, shifted, 13);
+            __m256i b1h = _mm256_shuffle_epi8(t1h, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+            __m256i b1l = _mm256_shuffle_epi8(t1l, _mm256_and_si256(prev1, nibble));
+            __m256i b2h = _mm256_shuffle_epi8(t2h, _mm256_and_si256(_mm256_srli_epi16(in, 4), nibble));
+            __m256i special = _mm256_and_si256(_mm256_and_si256(b1h, b1l), b2h);
+            // Bytes two or three after a 3- or 4-byte lead must be
+            // continuations; the tables flagged them as kTwoConts (0x80).
+            __m256i must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, third_lead), _mm256_subs_epu8(prev3, fourth_lead));
+            error = _mm256_xor_si256(_mm256_and_si256(must23, high_bit), special);
+            prev_incomplete = _mm256_subs_epu8(in, incomplete_max);
+        }
+        prev_input = in;
+        if (!_mm256_testz_si256(error, error)) {
+            result = i;
+            break;
+        }
+    }
+    _mm256_zeroupper();
+    return result;
+}
+
+std::size_t vector_find_invalid(const u8* s, std::size_t n) {
+    static const bool avx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+    if (!avx2) return scalar_find_invalid(s, n, 0);
+    std::size_t block = avx2_first_bad_block(s, n);
+    return block == kUtfNpos ? kUtfNpos : scalar_find_invalid(s, n, boundary_before(s, block));
+}
+#elif defined(__aarch64__)
+std::size_t neon_first_bad_block(const u8* s, std::size_t n) {
+    const uint8x16_t t1h = vld1q_u8(kByte1High);
+    const uint8x16_t t1l = vld1q_u8(kByte1Low);
+    const uint8x16_t t2h = vld1q_u8(kByte2High);
+    const uint8x16_t nibble = vdupq_n_u8(0x0F);
+    const uint8x16_t third_lead = vdupq_n_u8(0xE0 - 0x80);
+    const uint8x16_t fourth_lead = vdupq_n_u8(0xF0 - 0x80);
+    const uint8x16_t high_bit = vdupq_n_u8(0x80);
+    static const u8 kIncompleteMax[16] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                                          0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1};
+    const uint8x16_t incomplete_max = vld1q_u8(kIncompleteMax);
+
+    uint8x16_t prev_input = vdupq_n_u8(0);
+    uint8x16_t prev_incomplete = vdupq_n_u8(0);
+    u8 tail[16];
+
+    for (std::size_t i = 0; i <= n; i += 16) {
+        uint8x16_t in;
+        if (i + 16 <= n) {
+            in = vld1q_u8(s + i);
+        } else {
+            std::memset(tail, 0, sizeof(tail));
+            std::memcpy(tail, s + i, n - i);
+            in = vld1q_u8(tail);
+        }
+        uint8x16_t error;
+        if (vmaxvq_u8(in) < 0x80) {
+            error = prev_incomplete;
+            prev_incomplete = vdupq_n_u8(0);
+        } else {
+            uint8x16_t prev1 = vextq_u8(prev_input, in, 15);
+            uint8x16_t prev2 = vextq_u8(prev_input, in, 14);
+            uint8x16_t prev3 = vextq_u8(prev_input, in, 13);
+            uint8x16_t b1h = vqtbl1q_u8(t1h, vshrq_n_u8(prev1, 4));
+            uint8x16_t b1l = vqtbl1q_u8(t1l, vandq_u8(prev1, nibble));
+            uint8x16_t b2h = vqtbl1q_u8(t2h, vshrq_n_u8(in, 4));
+            uint8x16_t special = vandq_u8(vandq_u8(b1h, b1l), b2h);
+            uint8x16_t must23 = vorrq_u8(vqsubq_u8(prev2, third_lead), vqsubq_u8(prev3, fourth_lead));
+            error = veorq_u8(vandq_u8(must23, high_bit), special);
+            prev_incomplete = vqsubq_u8(in, incomplete_max);
+        }
+        prev_input = in;
+        if (vmaxvq_u8(error) != 0) return i;
+    }
+    return kUtfNpos;
+}
+
+std::size_t vector_find_invalid(const u8* s, std::size_t n) {
+    std::size_t block = neon_first_bad_block(s, n);
+    return block == kUtfNpos ? kUtfNpos : scalar_find_invalid(s, n, boundary_before(s, block));
+}
+#else
+std::size_t vector_find_invalid(const u8* s, std::size_t n) {
+    return scalar_find_invalid(s, n, 0);
+}
+#endif
+
+// ── ASCII fast paths for the transcoders ────────────────────────────────────
+// Each converts a prefix of whole blocks while the input is ASCII and
+// returns how many units it consumed.
+
+std::size_t ascii_to_utf16(const u8* s, std::size_t n, char16_t* out) {
+    std::size_t i = 0;
+#if defined(__x86_64__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        if (_mm_movemask_epi8(v) != 0) break;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), _mm_unpackhi_epi8(v, zero));
+    }
+#elif defined(__aarch64__)
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t v = vld1q_u8(s + i);
+        if (vmaxvq_u8(v) >= 0x80) break;
+        vst1q_u16(reinterpret_cast<std::uint16_t*>(out + i), vmovl_u8(vget_low_u8(v)));
+        vst1q_u16(reinterpret_cast<std::uint16_t*>(out + i + 8), vmovl_u8(vget_high_u8(v)));
+    }
+#else
+    for (; i + 8 <= n && ascii_word(s + i); i += 8) {
+        for (std::size_t k = 0; k < 8; ++k) out[i + k] = s[i + k];
+    }
+#endif
+    return i;
+}
+
+std::size_t ascii_to_utf32(const u8* s, std::size_t n, char32_t* out) {
+    std::size_t i = 0;
+#if defined(__x86_64__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        if (_mm_movemask_epi8(v) != 0) break;
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        auto* o = reinterpret_cast<__m128i*>(out + i);
+        _mm_storeu_si128(o, _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128(o + 1, _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128(o + 2, _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128(o + 3, _mm_unpackhi_epi16(hi, zero));
+    }
+#elif defined(__aarch64__)
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t v = vld1q_u8(s + i);
+        if (vmaxvq_u8(v) >= 0x80) break;
+        uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+        uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+        auto* o = reinterpret_cast<std::uint32_t*>(out + i);
+        vst1q_u32(o, vmovl_u16(vget_low_u16(lo)));
+        vst1q_u32(o + 4, vmovl_u16(vget_high_u16(lo)));
+        vst1q_u32(o + 8, vmovl_u16(vget_low_u16(hi)));
+        vst1q_u32(o + 12, vmovl_u16(vget_high_u16(hi)));
+    }
+#else
+    for (; i + 8 <= n && ascii_word(s + i); i += 8) {
+        for (std::size_t k = 0; k < 8; ++k) out[i + k] = s[i + k];
+    }
+#endif
+    return i;
+}
+
+std::size_t ascii_from_utf16(const char16_t* s, std::size_t n, char* out) {
+    std::size_t i = 0;
+#if defined(__x86_64__)
+    const __m128i non_ascii = _mm_set1_epi16(static_cast<short>(0xFF80));
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, non_ascii), zero)) != 0xFFFF) break;
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(v, v));
+    }
+#elif defined(__aarch64__)
+    for (; i + 8 <= n; i += 8) {
+        uint16x8_t v = vld1q_u16(reinterpret_cast<const std::uint16_t*>(s + i));
+        if (vmaxvq_u16(v) >= 0x80) break;
+        vst1_u8(reinterpret_cast<u8*>(out + i), vmovn_u16(v));
+    }
+#else
+    (void)s;
+    (void)n;
+    (void)out;
+#endif
+    return i;
+}
+
+std::size_t ascii_from_utf32(const char32_t* s, std::size_t n, char* out) {
+    std::size_t i = 0;
+#if defined(__x86_64__)
+    const __m128i non_ascii = _mm_set1_epi32(~0x7F);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= n; i += 8) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + 4));
+        __m128i bits = _mm_and_si128(_mm_or_si128(a, b), non_ascii);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(bits, zero)) != 0xFFFF) break;
+        __m128i words = _mm_packs_epi32(a, b);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(words, words));
+    }
+#elif defined(__aarch64__)
+    for (; i + 8 <= n; i += 8) {
+        uint32x4_t a = vld1q_u32(reinterpret_cast<const std::uint32_t*>(s + i));
+        uint32x4_t b = vld1q_u32(reinterpret_cast<const std::uint32_t*>(s + i + 4));
+        if (vmaxvq_u32(vorrq_u32(a, b)) >= 0x80) break;
+        vst1_u8(reinterpret_cast<u8*>(out + i), vmovn_u16(vcombine_u16(vmovn_u32(a), vmovn_u32(b))));
+    }
+#else
+    (void)s;
+    (void)n;
+    (void)out;
+#endif
+    return i;
+}
+
+// ── Encoding ────────────────────────────────────────────────────────────────
+
+inline std::size_t encode_utf8(char32_t cp, char* out) {
+    if (cp < 0x80) {
+        out[0] = static_cast<char>(cp);
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (cp >> 6));
+        out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (cp >> 12));
+        out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (cp >> 18));
+    out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+inline bool is_surrogate(char32_t cp) { return cp >= 0xD800 && cp <= 0xDFFF; }
+
+}  // namespace
+
+bool is_valid_utf8(std::string_view s) noexcept {
+    return find_invalid_utf8(s) == kUtfNpos;
+}
+
+std::size_t find_invalid_utf8(std::string_view s) noexcept {
+    return vector_find_invalid(reinterpret_cast<const u8*>(s.data()), s.size());
+}
+
+TranscodeResult utf8_to_utf16(std::string_view in, char16_t* out) noexcept {
+    const auto* s = reinterpret_cast<const u8*>(in.data());
+    const std::size_t n = in.size();
+    TranscodeResult r;
+    std::size_t i = 0;
+    while (i < n) {
+        if (s[i] < 0x80) {
+            std::size_t run = ascii_to_utf16(s + i, n - i, out + r.written);
+            if (run == 0) {
+                out[r.written] = s[i];
+                run = 1;
+            }
+            i += run;
+            r.written += run;
+            continue;
+        }
+        char32_t cp;
+        std::size_t len = decode(s, n, i, cp);
+        if (len == 0) {
+            r.error = i;
+            return r;
+        }
+        if (cp >= 0x10000) {
+            cp -= 0x10000;
+            out[r.written++] = static_cast<char16_t>(0xD800 + (cp >> 10));
+            out[r.written++] = static_cast<char16_t>(0xDC00 + (cp & 0x3FF));
+        } else {
+            out[r.written++] = static_cast<char16_t>(cp);
+        }
+        i += len;
+    }
+    return r;
+}
+
+TranscodeResult utf8_to_utf32(std::string_view in, char32_t* out) noexcept {
+    const auto* s = reinterpret_cast<const u8*>(in.data());
+    const std::size_t n = in.size();
+    TranscodeResult r;
+    std::size_t i = 0;
+    while (i < n) {
+        if (s[i] < 0x80) {
+            std::size_t run = ascii_to_utf32(s + i, n - i, out + r.written);
+            if (run == 0) {
+                out[r.written] = s[i];
+                run = 1;
+            }
+            i += run;
+            r.written += run;
+            continue;
+        }
+        char32_t cp;
+        std::size_t len = decode(s, n, i, cp);
+        if (len == 0) {
+            r.error = i;
+            return r;
+        }
+        out[r.written++] = cp;
+        i += len;
+    }
+    return r;
+}
+
+TranscodeResult utf16_to_utf8(std::u16string_view in, char* out) noexcept {
+    const char16_t* s = in.data();
+    const std::size_t n = in.size();
+    TranscodeResult r;
+    std::size_t i = 0;
+    while (i < n) {
+        char32_t cp = s[i];
+        if (cp < 0x80) {
+            std::size_t run = ascii_from_utf16(s + i, n - i, out + r.written);
+            if (run == 0) {
+                out[r.written] = static_cast<char>(cp);
+                run = 1;
+            }
+            i += run;
+            r.written += run;
+            continue;
+        }
+        std::size_t units = 1;
+        if (is_surrogate(cp)) {
+            if (cp >= 0xDC00 || i + 1 == n || s[i + 1] < 0xDC00 || s[i + 1] > 0xDFFF) {
+                r.error = i;
+                return r;
+            }
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (s[i + 1] - 0xDC00);
+            units = 2;
+        }
+        r.written += encode_utf8(cp, out + r.written);
+        i += units;
+    }
+    return r;
+}
+
+TranscodeResult utf32_to_utf8(std::u32string_view in, char* out) noexcept {
+    const char32_t* s = in.data();
+    const std::size_t n = in.size();
+    TranscodeResult r;
+    std::size_t i = 0;
+    while (i < n) {
+        char32_t cp = s[i];
+        if (cp < 0x80) {
+            std::size_t run = ascii_from_utf32(s + i, n - i, out + r.written);
+            if (run == 0) {
+                out[r.written] = static_cast<char>(cp);
+                run = 1;
+            }
+            i += run;
+            r.written += run;
+            continue;
+        }
+        if (cp > 0x10FFFF || is_surrogate(cp)) {
+            r.error = i;
+            return r;
+        }
+        r.written += encode_utf8(cp, out + r.written);
+        ++i;
+    }
+    return r;
+}
+
+std::size_t utf32_length_from_utf8(std::string_view in) noexcept {
+    std::size_t count = 0;
+    for (char c : in) count += (static_cast<u8>(c) & 0xC0) != 0x80;
+    return count;
+}
+
+std::size_t utf16_length_from_utf8(std::string_view in) noexcept {
+    // One unit per character plus one more for each 4-byte lead.
+    std::size_t count = 0;
+    for (char c : in) {
+        auto b = static_cast<u8>(c);
+        count += ((b & 0xC0) != 0x80) + (b >= 0xF0);
+    }
+    return count;
+}
+
+std::size_t utf8_length_from_utf16(std::u16string_view in) noexcept {
+    // A surrogate pair is four bytes: two per half.
+    std::size_t count = 0;
+    for (char16_t u : in) count += u < 0x80 ? 1 : u < 0x800 ? 2 : is_surrogate(u) ? 2 : 3;
+    return count;
+}
+
+std::size_t utf8_length_from_utf32(std::u32string_view in) noexcept {
+    std::size_t count = 0;
+    for (char32_t cp : in) count += cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+    return count;
+}
+
+}  // namespace stringutils
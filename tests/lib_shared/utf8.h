@@ -0,0 +1,46 @@
+// Shared library: UTF-8 validation and UTF-16/UTF-32 transcoding
+#ifndef UTF8_H
+#define UTF8_H
+
+#include <cstddef>
+#include <string_view>
+
+namespace stringutils {
+
+constexpr std::size_t kUtfNpos = static_cast<std::size_t>(-1);
+
+// Validation follows Unicode table 3-7: no overlong forms, no surrogates
+// (U+D800..U+DFFF), nothing above U+10FFFF, no truncated sequences.
+bool is_valid_utf8(std::string_view s) noexcept;
+// Offset of the first byte of the first invalid sequence, or kUtfNpos.
+std::size_t find_invalid_utf8(std::string_view s) noexcept;
+
+// Transcoders write into caller buffers and never allocate. Size the
+// output with the *_length_from_* functions below (exact for valid input)
+// or use the worst case: in.size() units for UTF-8 -> UTF-16/32,
+// 3 * in.size() bytes for UTF-16 -> UTF-8, 4 * in.size() for UTF-32.
+// Input is validated as it is decoded; on error `error` is the input
+// offset (in code units) of the bad sequence and `written` counts the
+// output units produced before it.
+struct TranscodeResult {
+    std::size_t written = 0;
+    std::size_t error = kUtfNpos;
+
+    constexpr bool ok() const noexcept { return error == kUtfNpos; }
+};
+
+TranscodeResult utf8_to_utf16(std::string_view in, char16_t* out) noexcept;
+TranscodeResult utf8_to_utf32(std::string_view in, char32_t* out) noexcept;
+// Unpaired surrogates are errors.
+TranscodeResult utf16_to_utf8(std::u16string_view in, char* out) noexcept;
+// Surrogate code points and values above U+10FFFF are errors.
+TranscodeResult utf32_to_utf8(std::u32string_view in, char* out) noexcept;
+
+std::size_t utf16_length_from_utf8(std::string_view in) noexcept;
+std::size_t utf32_length_from_utf8(std::string_view in) noexcept;
+std::size_t utf8_length_from_utf16(std::u16string_view in) noexcept;
+std::size_t utf8_length_from_utf32(std::u32string_view in) noexcept;
+
+}  // namespace stringutils
+
+#endif  // UTF8_H
@@ -0,0 +1,179 @@
+// Memory-mapped column file implementation
+#include "column_file.h"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mathlib {
+
+namespace {
+
+constexpr char kMagic[8] = {'M', 'L', 'C', 'O', 'L', '1', '\0', '\0'};
+constexpr std::size_t kNameLen = 32;
+constexpr std::size_t kHeaderSize = 8 + 4 + 4 + 8;
+constexpr std::size_t kDescriptorSize = kNameLen + 4 + 4 + 8;
+constexpr std::size_t kAlign = 64;
+
+std::runtime_error sys_error(const std::string& what, const std::string& path) {
+    return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+template <typename T>
+T read_le(const std::uint8_t* p) {
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    return v;
+}
+
+std::size_t page_size() {
+    static const std::size_t size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+std::size_t element_size(ColumnType type) {
+    switch (type) {
+        case ColumnType::Float64: return 8;
+        case ColumnType::Float32: return 4;
+    }
+    return 0;
+}
+
+}  // namespace
+
+// ── MappedFile ──────────────────────────────────────────────────────────────
+MappedFile::MappedFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw sys_error("cannot open", path);
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw sys_error("cannot stat", path);
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (size_ > 0) {
+        void* p = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            throw sys_error("cannot mmap", path);
+        }
+        data_ = static_cast<std::uint8_t*>(p);
+    }
+    // The mapping keeps its own reference to the file.
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data_) munmap(data_, size_);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept : data_(other.data_), size_(other.size_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        if (data_) munmap(data_, size_);
+        data_ = other.data_;
+        size_ = other.size_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+void MappedFile::advise_sequential() const {
+    if (data_) posix_madvise(data_, size_, POSIX_MADV_SEQUENTIAL);
+}
+
+void MappedFile::release(const void* p, std::size_t bytes) const {
+    if (!data_ || bytes == 0) return;
+    auto begin = reinterpret_cast<std::uintptr_t>(p);
+    auto end = begin + bytes;
+    std::uintptr_t page = page_size();
+    begin = (begin + page - 1) & ~(page - 1);
+    end &= ~(page - 1);
+    if (end <= begin) return;
+#if defined(MADV_DONTNEED)
+    // posix_madvise(POSIX_MADV_DONTNEED) is advisory only on Linux;
+    // madvise actually unmaps the clean file pages.
+    madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+#else
+    posix_madvise(reinterpret_cast<void*>(begin), end - begin, POSIX_MADV_DONTNEED);
+#endif
+}
+
+// ── ColumnFile ──────────────────────────────────────────────────────────────
+ColumnFile::ColumnFile(const std::string& path) : file_(path) {
+    const std::uint8_t* p = file_.data();
+    if (file_.size() < kHeaderSize || std::memcmp(p, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("not a column file: " + path);
+    }
+    auto count = read_le<std::uint32_t>(p + 8);
+    rows_ = read_le<std::uint64_t>(p + 16);
+    if (file_.size() < kHeaderSize + count * kDescriptorSize) {
+        throw std::runtime_error("truncated column file: " + path);
+    }
+    for (std::uint32_t i = 0; i < count; ++i) {
+        const std::uint8_t* d = p + kHeaderSize + i * kDescriptorSize;
+        ColumnInfo info;
+        info.name.assign(reinterpret_cast<const char*>(d), strnlen(reinterpret_cast<const char*>(d), kNameLen));
+        info.type = static_cast<ColumnType>(read_le<std::uint32_t>(d + kNameLen));
+        info.offset = read_le<std::uint64_t>(d + kNameLen + 8);
+        std::size_t elem = element_size(info.type);
+        if (elem == 0 || info.offset % elem != 0 || info.offset > file_.size() ||
+            (file_.size() - info.offset) / elem < rows_) {
+            throw std::runtime_error("bad column descriptor '" + info.name + "' in " + path);
+        }
+        columns_.push_back(std::move(info));
+    }
+}
+
+const ColumnInfo& ColumnFile::find(const std::string& name) const {
+    for (const auto& c : columns_) {
+        if (c.name == name) return c;
+    }
+    throw std::invalid_argument("no such column: " + name);
+}
+
+void write_column_file(const std::string& path, std::uint64_t rows, const std::vector<ColumnSpec>& columns) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw sys_error("cannot create", path);
+
+    std::vector<char> header(kHeaderSize + columns.size() * kDescriptorSize, 0);
+    std::memcpy(header.data(), kMagic, sizeof(kMagic));
+    auto count = static_cast<std::uint32_t>(columns.size());
+    std::memcpy(header.data() + 8, &count, 4);
+    std::memcpy(header.data() + 16, &rows, 8);
+
+    std::uint64_t offset = (header.size() + kAlign - 1) / kAlign * kAlign;
+    std::vector<std::uint64_t> offsets;
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        const auto& c = columns[i];
+        if (c.name.size() >= kNameLen) throw std::invalid_argument("column name too long: " + c.name);
+        char* d = header.data() + kHeaderSize + i * kDescriptorSize;
+        std::memcpy(d, c.name.data(), c.name.size());
+        auto type = static_cast<std::uint32_t>(c.type);
+        std::memcpy(d + kNameLen, &type, 4);
+        std::memcpy(d + kNameLen + 8, &offset, 8);
+        offsets.push_back(offset);
+        offset += (rows * element_size(c.type) + kAlign - 1) / kAlign * kAlign;
+    }
+
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    std::uint64_t pos = header.size();
+    static const char zeros[kAlign] = {};
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        out.write(zeros, static_cast<std::streamsize>(offsets[i] - pos));
+        std::uint64_t bytes = rows * element_size(columns[i].type);
+        out.write(static_cast<const char*>(columns[i].data), static_cast<std::streamsize>(bytes));
+        pos = offsets[i] + bytes;
+    }
+    if (!out) throw sys_error("cannot write", path);
+}
+
+}  // namespace mathlib
@@ -0,0 +1,123 @@
+// Static library: memory-mapped column files feeding the statistics
+#ifndef COLUMN_FILE_H
+#define COLUMN_FILE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "stats_view.h"
+
+namespace mathlib {
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+              "column files are little-endian and mapped without byte swapping");
+
+// Read-only mmap of a whole file. Throws std::runtime_error (with errno
+// text) when the file cannot be opened or mapped.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const std::uint8_t* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+    // Read-ahead hint for a front-to-back scan.
+    void advise_sequential() const;
+    // Drops the pages fully inside [p, p + bytes) from this process; they
+    // are re-read from the file if touched again. Keeps the resident set
+    // bounded when scanning files larger than RAM.
+    void release(const void* p, std::size_t bytes) const;
+
+private:
+    std::uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// A raw column file is just packed little-endian values.
+template <typename T>
+ArrayView<T> raw_column(const MappedFile& file) {
+    if (file.size() % sizeof(T) != 0) throw std::runtime_error("file size is not a multiple of the element size");
+    return ArrayView<T>(reinterpret_cast<const T*>(file.data()), file.size() / sizeof(T));
+}
+
+// Multi-column format: a fixed header followed by one descriptor per
+// column, then the column payloads, each 64-byte aligned.
+//
+//   char     magic[8] = "MLCOL1\0\0"
+//   uint32   column_count, reserved
+//   uint64   row_count
+//   column_count x { char name[32]; uint32 type; uint32 reserved; uint64 offset; }
+enum class ColumnType : std::uint32_t { Float64 = 1, Float32 = 2 };
+
+struct ColumnInfo {
+    std::string name;
+    ColumnType type;
+    std::uint64_t offset;
+};
+
+class ColumnFile {
+public:
+    explicit ColumnFile(const std::string& path);
+
+    std::uint64_t rows() const { return rows_; }
+    const std::vector<ColumnInfo>& columns() const { return columns_; }
+    const MappedFile& file() const { return file_; }
+
+    // Zero-copy view of a column. Throws std::invalid_argument for an
+    // unknown name or a type mismatch.
+    template <typename T>
+    ArrayView<T> column(const std::string& name) const {
+        const ColumnInfo& info = find(name);
+        if (info.type != type_of<T>()) throw std::invalid_argument("column type mismatch: " + name);
+        return ArrayView<T>(reinterpret_cast<const T*>(file_.data() + info.offset), rows_);
+    }
+
+private:
+    template <typename T>
+    static constexpr ColumnType type_of() {
+        static_assert(std::is_same_v<T, double> || std::is_same_v<T, float>, "unsupported column type");
+        return std::is_same_v<T, double> ? ColumnType::Float64 : ColumnType::Float32;
+    }
+    const ColumnInfo& find(const std::string& name) const;
+
+    MappedFile file_;
+    std::uint64_t rows_ = 0;
+    std::vector<ColumnInfo> columns_;
+};
+
+struct ColumnSpec {
+    std::string name;
+    ColumnType type;
+    const void* data;  // rows values of the given type
+};
+
+// Writes a multi-column file; throws std::runtime_error on I/O failure.
+void write_column_file(const std::string& path, std::uint64_t rows, const std::vector<ColumnSpec>& columns);
+
+// Streams a mapped column in chunks of `chunk_elements`, calling
+// fn(ArrayView<T>) for each and releasing pages behind the cursor, so a
+// scan touches at most about one chunk of resident memory at a time.
+template <typename T, typename Fn>
+void for_each_chunk(const MappedFile& file, ArrayView<T> column, std::size_t chunk_elements, Fn&& fn) {
+    if (chunk_elements == 0) chunk_elements = 1;
+    file.advise_sequential();
+    for (std::size_t i = 0; i < column.size(); i += chunk_elements) {
+        std::size_t n = std::min(chunk_elements, column.size() - i);
+        fn(ArrayView<T>(column.data() + i, n));
+        file.release(column.data() + i, n * sizeof(T));
+    }
+}
+
+}  // namespace mathlib
+
+#endif  // COLUMN_FILE_H
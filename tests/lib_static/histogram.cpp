@@ -0,0 +1,162 @@
+// Log-linear latency histogram implementation
+//
+// Index math follows HdrHistogram with a unit magnitude of zero: bucket b
+// covers [2^b * half, 2^(b+1) * half) with `half` linear sub-buckets, and
+// bucket 0 additionally covers [0, half).
+#include "histogram.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace mathlib {
+
+namespace {
+
+int bit_length(std::uint64_t v) { return v == 0 ? 0 : 64 - __builtin_clzll(v); }
+
+}  // namespace
+
+HistogramLayout::HistogramLayout(std::uint64_t highest_trackable, int significant_digits)
+    : highest_trackable_(highest_trackable), significant_digits_(significant_digits) {
+    if (significant_digits < 1 || significant_digits > 5) {
+        throw std::invalid_argument("significant digits must be 1..5");
+    }
+    if (highest_trackable < 2) throw std::invalid_argument("highest trackable value must be >= 2");
+
+    std::uint64_t largest_single_unit = 2;
+    for (int i = 0; i < significant_digits; ++i) largest_single_unit *= 10;
+    int sub_bucket_count_magnitude = bit_length(largest_single_unit - 1);
+    sub_bucket_half_count_magnitude_ = sub_bucket_count_magnitude - 1;
+    std::uint64_t sub_bucket_count = std::uint64_t{1} << sub_bucket_count_magnitude;
+    sub_bucket_half_count_ = sub_bucket_count / 2;
+    sub_bucket_mask_ = sub_bucket_count - 1;
+
+    // Number of power-of-two buckets needed to reach highest_trackable.
+    std::uint64_t smallest_untrackable = sub_bucket_count;
+    std::size_t buckets = 1;
+    while (smallest_untrackable <= highest_trackable) {
+        if (smallest_untrackable > (UINT64_MAX >> 1)) {
+            ++buckets;
+            break;
+        }
+        smallest_untrackable <<= 1;
+        ++buckets;
+    }
+    counts_len_ = (buckets + 1) * sub_bucket_half_count_;
+}
+
+std::size_t HistogramLayout::index_of(std::uint64_t value) const {
+    if (value > highest_trackable_) value = highest_trackable_;
+    int bucket = bit_length(value | sub_bucket_mask_) - (sub_bucket_half_count_magnitude_ + 1);
+    std::uint64_t sub_bucket = value >> bucket;
+    std::size_t base = static_cast<std::size_t>(bucket + 1) << sub_bucket_half_count_magnitude_;
+    return base + static_cast<std::size_t>(sub_bucket - sub_bucket_half_count_);
+}
+
+std::uint64_t HistogramLayout::lowest_equivalent(std::size_t index) const {
+    int bucket = static_cast<int>(index >> sub_bucket_half_count_magnitude_) - 1;
+    std::uint64_t sub_bucket = (index & (sub_bucket_half_count_ - 1)) + sub_bucket_half_count_;
+    if (bucket < 0) {
+        sub_bucket -= sub_bucket_half_count_;
+        bucket = 0;
+    }
+    return sub_bucket << bucket;
+}
+
+std::uint64_t HistogramLayout::highest_equivalent(std::size_t index) const {
+    int bucket = static_cast<int>(index >> sub_bucket_half_count_magnitude_) - 1;
+    if (bucket < 0) bucket = 0;
+    return lowest_equivalent(index) + (std::uint64_t{1} << bucket) - 1;
+}
+
+// ── HistogramSnapshot ───────────────────────────────────────────────────────
+HistogramSnapshot::HistogramSnapshot(const HistogramLayout& layout)
+    : layout_(layout), counts_(layout.bucket_count(), 0) {}
+
+std::uint64_t HistogramSnapshot::value_at_quantile(double q) const {
+    if (total_ == 0) throw std::invalid_argument("empty histogram");
+    if (!(q >= 0.0 && q <= 1.0)) throw std::invalid_argument("quantile outside [0, 1]");
+    auto target = static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(total_)));
+    if (target == 0) target = 1;
+    std::uint64_t cum = 0;
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+        cum += counts_[i];
+        if (cum >= target) return layout_.highest_equivalent(i);
+    }
+    return max();
+}
+
+std::uint64_t HistogramSnapshot::min() const {
+    if (total_ == 0) throw std::invalid_argument("empty histogram");
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+        if (counts_[i]) return layout_.lowest_equivalent(i);
+    }
+    return 0;
+}
+
+std::uint64_t HistogramSnapshot::max() const {
+    if (total_ == 0) throw std::invalid_argument("empty histogram");
+    for (std::size_t i = counts_.size(); i-- > 0;) {
+        if (counts_[i]) return layout_.highest_equivalent(i);
+    }
+    return 0;
+}
+
+double HistogramSnapshot::mean() const {
+    if (total_ == 0) throw std::invalid_argument("empty histogram");
+    double sum = 0.0;
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+        if (!counts_[i]) continue;
+        double mid = (static_cast<double>(layout_.lowest_equivalent(i)) +
+                      static_cast<double>(layout_.highest_equivalent(i))) / 2.0;
+        sum += mid * static_cast<double>(counts_[i]);
+    }
+    return sum / static_cast<double>(total_);
+}
+
+void HistogramSnapshot::merge(const HistogramSnapshot& other) {
+    if (!(layout_ == other.layout_)) throw std::invalid_argument("histogram layouts differ");
+    for (std::size_t i = 0; i < counts_.size(); ++i) counts_[i] += other.counts_[i];
+    total_ += other.total_;
+}
+
+// ── LatencyHistogram ────────────────────────────────────────────────────────
+LatencyHistogram::LatencyHistogram(std::uint64_t highest_trackable, int significant_digits)
+    : layout_(highest_trackable, significant_digits),
+      counts_(new std::atomic<std::uint64_t>[layout_.bucket_count()]) {
+    reset();
+}
+
+void LatencyHistogram::add(const HistogramSnapshot& snapshot) {
+    if (!(layout_ == snapshot.layout())) throw std::invalid_argument("histogram layouts differ");
+    for (std::size_t i = 0; i < layout_.bucket_count(); ++i) {
+        if (snapshot.counts_[i]) counts_[i].fetch_add(snapshot.counts_[i], std::memory_order_relaxed);
+    }
+}
+
+HistogramSnapshot LatencyHistogram::snapshot() const {
+    HistogramSnapshot s(layout_);
+    for (std::size_t i = 0; i < layout_.bucket_count(); ++i) {
+        s.counts_[i] = counts_[i].load(std::memory_order_relaxed);
+        s.total_ += s.counts_[i];
+    }
+    return s;
+}
+
+HistogramSnapshot LatencyHistogram::snapshot_and_reset() {
+    HistogramSnapshot s(layout_);
+    for (std::size_t i = 0; i < layout_.bucket_count(); ++i) {
+        // Skip the exchange (and the cache-line write) for idle buckets.
+        if (counts_[i].load(std::memory_order_relaxed) == 0) continue;
+        s.counts_[i] = counts_[i].exchange(0, std::memory_order_relaxed);
+        s.total_ += s.counts_[i];
+    }
+    return s;
+}
+
+void LatencyHistogram::reset() {
+    for (std::size_t i = 0; i < layout_.bucket_count(); ++i) {
+        counts_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+}  // namespace mathlib
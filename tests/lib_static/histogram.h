@@ -0,0 +1,106 @@
+// Static library: log-linear (HDR-style) latency histogram
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace mathlib {
+
+// Bucket layout shared by the recorder and its snapshots. Values from 1 to
+// highest_trackable are kept to significant_digits decimal digits of
+// precision: each power-of-two range is split into 2^m linear sub-buckets,
+// where 2^m >= 2 * 10^digits. Values above highest_trackable are clamped
+// into the top bucket; zero is counted in the first bucket.
+class HistogramLayout {
+public:
+    HistogramLayout(std::uint64_t highest_trackable, int significant_digits);
+
+    std::size_t bucket_count() const { return counts_len_; }
+    std::uint64_t highest_trackable() const { return highest_trackable_; }
+    int significant_digits() const { return significant_digits_; }
+
+    std::size_t index_of(std::uint64_t value) const;
+    std::uint64_t lowest_equivalent(std::size_t index) const;
+    std::uint64_t highest_equivalent(std::size_t index) const;
+
+    bool operator==(const HistogramLayout& o) const {
+        return highest_trackable_ == o.highest_trackable_ &&
+               significant_digits_ == o.significant_digits_;
+    }
+
+private:
+    std::uint64_t highest_trackable_;
+    int significant_digits_;
+    int sub_bucket_half_count_magnitude_;
+    std::uint64_t sub_bucket_half_count_;
+    std::uint64_t sub_bucket_mask_;
+    std::size_t counts_len_;
+};
+
+// Plain (non-atomic) copy of a histogram's counts, used for queries and
+// for merging intervals or per-process results.
+class HistogramSnapshot {
+public:
+    explicit HistogramSnapshot(const HistogramLayout& layout);
+
+    const HistogramLayout& layout() const { return layout_; }
+    std::uint64_t total_count() const { return total_; }
+    std::uint64_t count_at_index(std::size_t i) const { return counts_[i]; }
+
+    // Throw std::invalid_argument when empty or q is outside [0, 1]. Results
+    // are the highest value equivalent to the selected bucket, so they are
+    // accurate to the layout's precision.
+    std::uint64_t value_at_quantile(double q) const;
+    std::uint64_t min() const;
+    std::uint64_t max() const;
+    double mean() const;
+
+    // Throws std::invalid_argument if the layouts differ.
+    void merge(const HistogramSnapshot& other);
+
+private:
+    friend class LatencyHistogram;
+    HistogramLayout layout_;
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t total_ = 0;
+};
+
+// Concurrent recorder. record() is a single relaxed fetch_add on one
+// bucket counter: no locks and no CAS loops, so any number of threads can
+// record at once. Queries go through snapshots; snapshot_and_reset()
+// exchanges each counter with zero, so an event recorded concurrently
+// lands in exactly one interval.
+class LatencyHistogram {
+public:
+    explicit LatencyHistogram(std::uint64_t highest_trackable = 3600ull * 1000 * 1000 * 1000,
+                              int significant_digits = 3);
+
+    void record(std::uint64_t value) noexcept {
+        counts_[layout_.index_of(value)].fetch_add(1, std::memory_order_relaxed);
+    }
+    void record_n(std::uint64_t value, std::uint64_t n) noexcept {
+        counts_[layout_.index_of(value)].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    // Adds a snapshot's counts (e.g. from another process) into this one.
+    void add(const HistogramSnapshot& snapshot);
+
+    HistogramSnapshot snapshot() const;
+    HistogramSnapshot snapshot_and_reset();
+    void reset();
+
+    const HistogramLayout& layout() const { return layout_; }
+    std::size_t memory_bytes() const { return layout_.bucket_count() * sizeof(std::atomic<std::uint64_t>); }
+
+private:
+    HistogramLayout layout_;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> counts_;
+};
+
+}  // namespace mathlib
+
+#endif  // HISTOGRAM_H
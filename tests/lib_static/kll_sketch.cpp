@@ -0,0 +1,230 @@
+// KLL quantile sketch implementation
+#include "kll_sketch.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace mathlib {
+
+namespace {
+
+constexpr std::uint32_t kMagic = 0x4B4C4C31;  // "KLL1"
+
+template <typename T>
+void put(std::vector<std::uint8_t>& out, const T& v) {
+    auto p = reinterpret_cast<const std::uint8_t*>(&v);
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+template <typename T>
+T get(const std::uint8_t*& p, const std::uint8_t* end) {
+    if (static_cast<std::size_t>(end - p) < sizeof(T)) throw std::invalid_argument("truncated sketch");
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    p += sizeof(T);
+    return v;
+}
+
+}  // namespace
+
+KllSketch::KllSketch(std::uint32_t k) : k_(k) {
+    if (k < 8) throw std::invalid_argument("sketch k must be at least 8");
+    add_level();
+}
+
+std::size_t KllSketch::capacity(std::size_t level) const {
+    std::size_t depth = levels_.size() - level - 1;
+    return static_cast<std::size_t>(std::ceil(k_ * std::pow(2.0 / 3.0, static_cast<double>(depth)))) + 1;
+}
+
+void KllSketch::add_level() {
+    levels_.emplace_back();
+    max_size_ = 0;
+    for (std::size_t h = 0; h < levels_.size(); ++h) max_size_ += capacity(h);
+}
+
+std::size_t KllSketch::retained() const { return size_; }
+
+void KllSketch::update(double value) {
+    if (n_ == 0) {
+        min_ = max_ = value;
+    } else {
+        if (value < min_) min_ = value;
+        if (value > max_) max_ = value;
+    }
+    ++n_;
+    levels_[0].push_back(value);
+    ++size_;
+    if (size_ >= max_size_) compress();
+}
+
+void KllSketch::compress() {
+    for (std::size_t h = 0; h < levels_.size(); ++h) {
+        if (levels_[h].size() < capacity(h)) continue;
+        if (h + 1 >= levels_.size()) add_level();
+
+        auto& level = levels_[h];
+        std::sort(level.begin(), level.end());
+        // An odd leftover stays behind so total weight is preserved.
+        double carry = 0.0;
+        bool has_carry = level.size() % 2 == 1;
+        if (has_carry) {
+            carry = level.back();
+            level.pop_back();
+        }
+        // xorshift64: a fair coin picks even or odd survivors.
+        rng_state_ ^= rng_state_ << 13;
+        rng_state_ ^= rng_state_ >> 7;
+        rng_state_ ^= rng_state_ << 17;
+        std::size_t offset = rng_state_ & 1u;
+        auto& next = levels_[h + 1];
+        for (std::size_t i = offset; i < level.size(); i += 2) next.push_back(level[i]);
+        size_ -= level.size() / 2;
+        level.clear();
+        if (has_carry) level.push_back(carry);
+        // Lazy compaction: stop as soon as one level has made room.
+        if (size_ < max_size_) return;
+    }
+}
+
+void KllSketch::merge(const KllSketch& other) {
+    if (other.n_ == 0) return;
+    if (n_ == 0) {
+        min_ = other.min_;
+        max_ = other.max_;
+    } else {
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+    n_ += other.n_;
+    while (levels_.size() < other.levels_.size()) add_level();
+    for (std::size_t h = 0; h < other.levels_.size(); ++h) {
+        levels_[h].insert(levels_[h].end(), other.levels_[h].begin(), other.levels_[h].end());
+        size_ += other.levels_[h].size();
+    }
+    while (size_ >= max_size_) {
+        std::size_t before = size_;
+        compress();
+        if (size_ == before) break;
+    }
+}
+
+std::vector<std::pair<double, std::uint64_t>> KllSketch::weighted_items() const {
+    std::vector<std::pair<double, std::uint64_t>> items;
+    items.reserve(size_);
+    for (std::size_t h = 0; h < levels_.size(); ++h) {
+        for (double v : levels_[h]) items.emplace_back(v, std::uint64_t{1} << h);
+    }
+    std::sort(items.begin(), items.end());
+    return items;
+}
+
+double KllSketch::min() const {
+    if (n_ == 0) throw std::invalid_argument("empty sketch");
+    return min_;
+}
+
+double KllSketch::max() const {
+    if (n_ == 0) throw std::invalid_argument("empty sketch");
+    return max_;
+}
+
+double KllSketch::quantile(double q) const { return quantiles({q})[0]; }
+
+std::vector<double> KllSketch::quantiles(const std::vector<double>& probs) const {
+    if (n_ == 0) throw std::invalid_argument("empty sketch");
+    for (double p : probs) {
+        if (!(p >= 0.0 && p <= 1.0)) throw std::invalid_argument("quantile outside [0, 1]");
+    }
+    auto items = weighted_items();
+    std::uint64_t total = 0;
+    for (const auto& it : items) total += it.second;
+
+    std::vector<double> result;
+    result.reserve(probs.size());
+    for (double p : probs) {
+        if (p == 0.0) { result.push_back(min_); continue; }
+        if (p == 1.0) { result.push_back(max_); continue; }
+        double target = p * static_cast<double>(total);
+        std::uint64_t cum = 0;
+        double v = items.back().first;
+        for (const auto& it : items) {
+            cum += it.second;
+            if (static_cast<double>(cum) >= target) {
+                v = it.first;
+                break;
+            }
+        }
+        result.push_back(v);
+    }
+    return result;
+}
+
+double KllSketch::rank(double value) const {
+    if (n_ == 0) throw std::invalid_argument("empty sketch");
+    std::uint64_t below = 0, total = 0;
+    for (std::size_t h = 0; h < levels_.size(); ++h) {
+        std::uint64_t w = std::uint64_t{1} << h;
+        for (double v : levels_[h]) {
+            total += w;
+            if (v <= value) below += w;
+        }
+    }
+    return static_cast<double>(below) / static_cast<double>(total);
+}
+
+std::vector<std::uint8_t> KllSketch::serialize() const {
+    std::vector<std::uint8_t> out;
+    out.reserve(48 + levels_.size() * 4 + size_ * sizeof(double));
+    put(out, kMagic);
+    put(out, k_);
+    put(out, n_);
+    put(out, min_);
+    put(out, max_);
+    put(out, rng_state_);
+    put(out, static_cast<std::uint32_t>(levels_.size()));
+    for (const auto& level : levels_) {
+        put(out, static_cast<std::uint32_t>(level.size()));
+        for (double v : level) put(out, v);
+    }
+    return out;
+}
+
+KllSketch KllSketch::deserialize(const std::uint8_t* data, std::size_t size) {
+    const std::uint8_t* p = data;
+    const std::uint8_t* end = data + size;
+    if (get<std::uint32_t>(p, end) != kMagic) throw std::invalid_argument("not a KLL sketch");
+    KllSketch s(get<std::uint32_t>(p, end));
+    s.n_ = get<std::uint64_t>(p, end);
+    s.min_ = get<double>(p, end);
+    s.max_ = get<double>(p, end);
+    s.rng_state_ = get<std::uint64_t>(p, end);
+    auto num_levels = get<std::uint32_t>(p, end);
+    if (num_levels == 0 || num_levels > 64) throw std::invalid_argument("bad sketch level count");
+    while (s.levels_.size() < num_levels) s.add_level();
+    s.size_ = 0;
+    std::uint64_t weight = 0;
+    for (std::size_t h = 0; h < s.levels_.size(); ++h) {
+        auto count = get<std::uint32_t>(p, end);
+        if (static_cast<std::size_t>(end - p) / sizeof(double) < count) {
+            throw std::invalid_argument("truncated sketch");
+        }
+        if (count > (~std::uint64_t{0} - weight) >> h) {
+            throw std::invalid_argument("sketch weight overflows");
+        }
+        weight += std::uint64_t{count} << h;
+        auto& level = s.levels_[h];
+        level.resize(count);
+        if (count != 0) std::memcpy(level.data(), p, count * sizeof(double));
+        p += count * sizeof(double);
+        s.size_ += count;
+    }
+    if (p != end) throw std::invalid_argument("trailing bytes after sketch");
+    // Compaction preserves weight, so the levels must account for every item.
+    if (weight != s.n_) throw std::invalid_argument("sketch count does not match its levels");
+    if (s.n_ != 0 && !(s.min_ <= s.max_)) throw std::invalid_argument("sketch min exceeds max");
+    return s;
+}
+
+}  // namespace mathlib
@@ -1,5 +1,6 @@
 // Static library implementation
 #include "mathlib.h"
+#include "simd_kernels.h"
 
 namespace mathlib {
 
@@ -14,29 +15,85 @@ double divide(double a, double b) {
 
 double mean(const std::vector<double>& data) {
     if (data.empty()) throw std::invalid_argument("empty data");
-    double sum = std::accumulate(data.begin(), data.end(), 0.0);
+    double sum = simd::sum(data.data(), data.size());
     return sum / static_cast<double>(data.size());
 }
 
 double standard_deviation(const std::vector<double>& data) {
     if (data.size() < 2) throw std::invalid_argument("need at least 2 values");
     double m = mean(data);
-    double sq_sum = 0.0;
-    for (auto v : data) {
-        double diff = v - m;
-        sq_sum += diff * diff;
-    }
+    double sq_sum = simd::sum_sq_dev(data.data(), data.size(), m);
     return std::sqrt(sq_sum / static_cast<double>(data.size() - 1));
 }
 
 double median(std::vector<double> data) {
     if (data.empty()) throw std::invalid_argument("empty data");
-    std::sort(data.begin(), data.end());
     auto n = data.size();
+    auto mid = data.begin() + static_cast<std::ptrdiff_t>(n / 2);
+    std::nth_element(data.begin(), mid, data.end());
     if (n % 2 == 0) {
-        return (data[n / 2 - 1] + data[n / 2]) / 2.0;
+        // Everything left of mid is <= *mid, so its maximum is rank n/2 - 1.
+        return (*std::max_element(data.begin(), mid) + *mid) / 2.0;
+    }
+    return *mid;
+}
+
+namespace {
+
+// Places the elements of rank ranks[lo..hi) at their sorted positions in
+// [first, last). Selects the middle rank first, then recurses into the two
+// halves so each level only partitions the sub-range it owns.
+void multi_select(double* first, double* last, const std::size_t* ranks,
+                  std::size_t lo, std::size_t hi, double* base) {
+    if (lo >= hi || first >= last) return;
+    std::size_t mid = lo + (hi - lo) / 2;
+    double* nth = base + ranks[mid];
+    std::nth_element(first, nth, last);
+    multi_select(first, nth, ranks, lo, mid, base);
+    multi_select(nth + 1, last, ranks, mid + 1, hi, base);
+}
+
+}  // namespace
+
+std::vector<double> quantiles_inplace(double* data, std::size_t n, const std::vector<double>& probs) {
+    if (n == 0) throw std::invalid_argument("empty data");
+    for (double p : probs) {
+        if (!(p >= 0.0 && p <= 1.0)) throw std::invalid_argument("quantile outside [0, 1]");
     }
-    return data[n / 2];
+
+    // Linear interpolation between closest ranks (h = p * (n - 1)), which
+    // agrees with median() at p = 0.5.
+    std::vector<std::size_t> ranks;
+    ranks.reserve(probs.size() * 2);
+    for (double p : probs) {
+        double h = p * static_cast<double>(n - 1);
+        auto r = static_cast<std::size_t>(h);
+        ranks.push_back(r);
+        if (r + 1 < n && h > static_cast<double>(r)) ranks.push_back(r + 1);
+    }
+    std::sort(ranks.begin(), ranks.end());
+    ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+    multi_select(data, data + n, ranks.data(), 0, ranks.size(), data);
+
+    std::vector<double> result;
+    result.reserve(probs.size());
+    for (double p : probs) {
+        double h = p * static_cast<double>(n - 1);
+        auto r = static_cast<std::size_t>(h);
+        double frac = h - static_cast<double>(r);
+        double v = data[r];
+        if (r + 1 < n && frac > 0.0) v += frac * (data[r + 1] - v);
+        result.push_back(v);
+    }
+    return result;
+}
+
+std::vector<double> quantiles_inplace(std::vector<double>& data, const std::vector<double>& probs) {
+    return quantiles_inplace(data.data(), data.size(), probs);
+}
+
+std::vector<double> quantiles(std::vector<double> data, const std::vector<double>& probs) {
+    return quantiles_inplace(data.data(), data.size(), probs);
 }
 
 }  // namespace mathlib
@@ -20,6 +20,14 @@ double mean(const std::vector<double>& data);
 double standard_deviation(const std::vector<double>& data);
 double median(std::vector<double> data);  // takes by value intentionally
 
+// Quantiles for probabilities in [0, 1], linearly interpolated between the
+// closest ranks. Uses selection rather than a full sort: O(n log k) for k
+// requested quantiles. The _inplace forms reorder the caller's buffer
+// instead of copying it.
+std::vector<double> quantiles(std::vector<double> data, const std::vector<double>& probs);
+std::vector<double> quantiles_inplace(std::vector<double>& data, const std::vector<double>& probs);
+std::vector<double> quantiles_inplace(double* data, std::size_t n, const std::vector<double>& probs);
+
 // Template function (in header)
 template <typename T>
 T clamp(T value, T low, T high) {
@@ -0,0 +1,283 @@
+// Throughput benchmarks for mathlib statistics kernels
+//
+// Usage: mathlib_bench [max_elements]   (default 10000000)
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <string>
+#include <cstdlib>
+#include <thread>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include "mathlib.h"
+#include "kll_sketch.h"
+#include "histogram.h"
+#include "sliding_window.h"
+#include "stats_view.h"
+#include "parallel_stats.h"
+#include "column_file.h"
+#include "running_stats.h"
+#include "simd_kernels.h"
+
+namespace {
+
+// Runs fn until at least ~50 ms have elapsed and returns ns per call.
+template <typename Fn>
+double time_ns(Fn&& fn) {
+    using clock = std::chrono::steady_clock;
+    std::size_t iters = 0;
+    auto start = clock::now();
+    auto elapsed = clock::duration::zero();
+    do {
+        fn();
+        ++iters;
+        elapsed = clock::now() - start;
+    } while (elapsed < std::chrono::milliseconds(50));
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iters);
+}
+
+volatile double g_sink;
+
+// Peak resident set size so far, in KB (0 where the OS does not report it).
+long peak_rss_kb() {
+    struct rusage ru;
+    return getrusage(RUSAGE_SELF, &ru) == 0 ? ru.ru_maxrss : 0;
+}
+
+// Runs first, before other sections grow the peak RSS: streams a raw
+// column file through mmap, then reads the same file into a vector.
+void bench_column_file(std::size_t n) {
+    std::cout << "\n--- column file, n=" << n << " doubles ---\n";
+    const char* tmp = std::getenv("TMPDIR");
+    std::string path = std::string(tmp ? tmp : "/tmp") + "/mathlib_bench_" + std::to_string(getpid()) + ".f64";
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        std::vector<double> block(1 << 16);
+        std::mt19937_64 rng(3);
+        std::normal_distribution<double> normal(0.0, 1.0);
+        for (std::size_t done = 0; done < n; done += block.size()) {
+            std::size_t m = std::min(block.size(), n - done);
+            for (std::size_t i = 0; i < m; ++i) block[i] = normal(rng);
+            out.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(m * sizeof(double)));
+        }
+    }
+    using clock = std::chrono::steady_clock;
+    long rss_start = peak_rss_kb();
+
+    auto t0 = clock::now();
+    double mapped_sd;
+    {
+        mathlib::MappedFile file(path);
+        auto column = mathlib::raw_column<double>(file);
+        mathlib::RunningStats stats;
+        mathlib::for_each_chunk(file, column, 1 << 16,
+                                [&](mathlib::ArrayView<double> c) { stats.push(c.data(), c.size()); });
+        mapped_sd = stats.standard_deviation();
+    }
+    double t_mapped = std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+    long rss_mapped = peak_rss_kb();
+
+    t0 = clock::now();
+    double vector_sd;
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::vector<double> data(n);
+        in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(n * sizeof(double)));
+        vector_sd = mathlib::standard_deviation(data);
+    }
+    double t_vector = std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+    long rss_vector = peak_rss_kb();
+    std::remove(path.c_str());
+
+    std::cout << "mmap+stream:  " << t_mapped << " ms to stddev=" << mapped_sd
+              << ", peak RSS +" << rss_mapped - rss_start << " KB\n";
+    std::cout << "read+vector:  " << t_vector << " ms to stddev=" << vector_sd
+              << ", peak RSS +" << rss_vector - rss_mapped << " KB\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::size_t max_n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+    std::cout << "=== mathlib benchmark ===\n";
+    std::cout << "dispatch: " << mathlib::simd::isa_name(mathlib::simd::kernels().isa) << "\n";
+
+    bench_column_file(max_n);
+
+    // ── SIMD kernels vs scalar reference ────────────────────────────────────
+    std::cout << "\n--- simd kernels (GB/s of input read) ---\n";
+    std::cout << std::left << std::setw(10) << "n" << std::setw(8) << "isa"
+              << std::setw(10) << "sum" << std::setw(10) << "sumsq"
+              << std::setw(10) << "minmax" << std::setw(10) << "dot" << "\n";
+    std::mt19937_64 rng(1);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    for (std::size_t n = 1000; n <= max_n; n *= 10) {
+        std::vector<double> a(n), b(n);
+        for (std::size_t i = 0; i < n; ++i) { a[i] = dist(rng); b[i] = dist(rng); }
+        double bytes = static_cast<double>(n * sizeof(double));
+        for (auto isa : {mathlib::simd::Isa::Scalar, mathlib::simd::Isa::AVX2,
+                         mathlib::simd::Isa::AVX512, mathlib::simd::Isa::NEON}) {
+            const auto* k = mathlib::simd::kernels_for(isa);
+            if (!k) continue;
+            double t_sum = time_ns([&] { g_sink = k->sum(a.data(), n); });
+            double t_sq = time_ns([&] { g_sink = k->sum_sq_dev(a.data(), n, 0.5); });
+            double t_mm = time_ns([&] { double lo, hi; k->min_max(a.data(), n, &lo, &hi); g_sink = lo + hi; });
+            double t_dot = time_ns([&] { g_sink = k->dot(a.data(), b.data(), n); });
+            std::cout << std::setw(10) << n << std::setw(8) << mathlib::simd::isa_name(isa)
+                      << std::fixed << std::setprecision(2)
+                      << std::setw(10) << bytes / t_sum << std::setw(10) << bytes / t_sq
+                      << std::setw(10) << bytes / t_mm << std::setw(10) << 2 * bytes / t_dot
+                      << "\n";
+            std::cout.unsetf(std::ios::fixed);
+            std::cout << std::setprecision(6);
+        }
+    }
+
+    // ── Quantiles: selection vs full sort ───────────────────────────────────
+    std::cout << "\n--- p50/p90/p99/p99.9 (ms per call, includes copy) ---\n";
+    std::exponential_distribution<double> latency(0.01);
+    for (std::size_t n = 1000; n <= max_n; n *= 10) {
+        std::vector<double> data(n);
+        for (auto& v : data) v = latency(rng);
+        const std::vector<double> probs = {0.5, 0.9, 0.99, 0.999};
+        double t_sort = time_ns([&] {
+            std::vector<double> copy = data;
+            std::sort(copy.begin(), copy.end());
+            g_sink = copy[static_cast<std::size_t>(0.999 * static_cast<double>(n - 1))];
+        });
+        double t_select = time_ns([&] { g_sink = mathlib::quantiles(data, probs)[3]; });
+        std::cout << std::setw(10) << n << " sort " << t_sort / 1e6
+                  << "  select " << t_select / 1e6 << "\n";
+    }
+
+    // ── KLL sketch: insert throughput and accuracy vs exact median ─────────
+    std::cout << "\n--- kll sketch (k=200) ---\n";
+    {
+        std::size_t n = max_n;
+        std::vector<double> skewed(n), heavy(n);
+        std::lognormal_distribution<double> lognormal(0.0, 2.0);
+        std::cauchy_distribution<double> cauchy(0.0, 1.0);
+        for (std::size_t i = 0; i < n; ++i) {
+            skewed[i] = lognormal(rng);
+            heavy[i] = std::fabs(cauchy(rng));
+        }
+        for (const auto* set : {&skewed, &heavy}) {
+            const auto& data = *set;
+            auto start = std::chrono::steady_clock::now();
+            mathlib::KllSketch sketch;
+            for (double v : data) sketch.update(v);
+            double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::vector<double> sorted = data;
+            std::sort(sorted.begin(), sorted.end());
+            std::cout << (set == &skewed ? "lognormal" : "|cauchy| ") << "  "
+                      << static_cast<double>(n) / secs / 1e6 << " M inserts/s, "
+                      << sketch.serialize().size() << " bytes\n";
+            for (double q : {0.5, 0.9, 0.99, 0.999}) {
+                double est = sketch.quantile(q);
+                double r = static_cast<double>(std::upper_bound(sorted.begin(), sorted.end(), est) -
+                                               sorted.begin()) / static_cast<double>(n);
+                std::cout << "  q=" << q << " est=" << est << " rank_err=" << std::fabs(r - q);
+                if (q == 0.5) std::cout << " exact_median=" << mathlib::median(data);
+                std::cout << "\n";
+            }
+        }
+    }
+
+    // ── Latency histogram: concurrent record() throughput ──────────────────
+    std::cout << "\n--- latency histogram record() (M records/s) ---\n";
+    {
+        unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+        const std::uint64_t per_thread = 5000000;
+        for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+            mathlib::LatencyHistogram hist;
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::thread> workers;
+            for (unsigned t = 0; t < threads; ++t) {
+                workers.emplace_back([&hist, t] {
+                    std::uint64_t x = 0x9E3779B97F4A7C15ull * (t + 1);
+                    for (std::uint64_t i = 0; i < per_thread; ++i) {
+                        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+                        hist.record(x & 0xFFFFF);  // ~1 ms range in ns
+                    }
+                });
+            }
+            for (auto& w : workers) w.join();
+            double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            auto snap = hist.snapshot();
+            std::cout << std::setw(3) << threads << " threads: "
+                      << static_cast<double>(snap.total_count()) / secs / 1e6
+                      << "  (p99=" << snap.value_at_quantile(0.99) << ")\n";
+        }
+    }
+
+    // ── Sliding window: per-tick cost vs recomputing over a copied window ──
+    std::cout << "\n--- sliding window stats per tick (ns) ---\n";
+    for (std::size_t window : {64, 1024, 16384}) {
+        std::vector<double> ring(window);
+        for (auto& v : ring) v = dist(rng);
+        mathlib::SlidingWindow win(window);
+        for (double v : ring) win.push(v);
+        std::size_t pos = 0;
+        double t_window = time_ns([&] {
+            win.push(ring[pos++ % window]);
+            g_sink = win.mean() + win.standard_deviation() + win.min() + win.max();
+        });
+        double t_copy = time_ns([&] {
+            std::vector<double> copy(ring.begin(), ring.end());
+            auto mm = std::minmax_element(copy.begin(), copy.end());
+            g_sink = mathlib::mean(copy) + mathlib::standard_deviation(copy) + *mm.first + *mm.second;
+        });
+        std::cout << std::setw(8) << window << " window " << t_window << "  copy+recompute " << t_copy << "\n";
+    }
+
+    // ── Typed statistics vs converting int16 ADC data to vector<double> ───
+    std::cout << "\n--- int16 mean+stddev (ms per call) ---\n";
+    for (std::size_t n = 1000; n <= max_n; n *= 10) {
+        std::vector<std::int16_t> adc(n);
+        std::uniform_int_distribution<int> code(-2048, 2047);
+        for (auto& v : adc) v = static_cast<std::int16_t>(code(rng));
+        double t_convert = time_ns([&] {
+            std::vector<double> copy(adc.begin(), adc.end());
+            g_sink = mathlib::mean(copy) + mathlib::standard_deviation(copy);
+        });
+        double t_typed = time_ns([&] {
+            g_sink = mathlib::try_mean(adc).value + mathlib::try_standard_deviation(adc).value;
+        });
+        std::cout << std::setw(10) << n << " convert+copy " << t_convert / 1e6
+                  << "  typed " << t_typed / 1e6 << "\n";
+    }
+
+    // ── Parallel reductions: scaling from 1 to N workers ───────────────────
+    std::cout << "\n--- parallel mean/stddev/median, n=" << max_n << " (ms) ---\n";
+    {
+        std::vector<double> big(max_n);
+        std::normal_distribution<double> normal(0.0, 1.0);
+        for (auto& v : big) v = normal(rng);
+        unsigned cpus = mathlib::default_worker_count();
+        for (unsigned workers = 1; workers <= cpus; workers = workers < cpus && workers * 2 > cpus ? cpus : workers * 2) {
+            mathlib::WorkerPool pool(workers);
+            mathlib::ParallelOptions opts;
+            opts.pool = &pool;
+            opts.serial_threshold = 0;
+            double t_mean = time_ns([&] { g_sink = mathlib::parallel_mean(big, opts); });
+            double t_sd = time_ns([&] { g_sink = mathlib::parallel_standard_deviation(big, opts); });
+            double t_med = time_ns([&] { g_sink = mathlib::parallel_median(big, opts); });
+            std::cout << std::setw(3) << workers << " workers: mean " << t_mean / 1e6
+                      << "  stddev " << t_sd / 1e6 << "  median " << t_med / 1e6 << "\n";
+            if (workers == cpus) break;
+        }
+        double t_serial_median = time_ns([&] { g_sink = mathlib::median(big); });
+        std::cout << "serial median (copy + nth_element): " << t_serial_median / 1e6 << "\n";
+    }
+
+    std::cout << "\nmathlib benchmark done.\n";
+    return 0;
+}
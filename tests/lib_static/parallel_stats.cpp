@@ -0,0 +1,233 @@
+// Parallel reductions implementation
+#include "parallel_stats.h"
+#include "mathlib.h"
+#include "simd_kernels.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__QNXNTO__)
+#include <sys/syspage.h>
+#endif
+
+namespace mathlib {
+
+unsigned default_worker_count() {
+#if defined(__QNXNTO__)
+    unsigned n = _syspage_ptr->num_cpu;
+#else
+    unsigned n = std::thread::hardware_concurrency();
+#endif
+    return n > 0 ? n : 1;
+}
+
+// ── WorkerPool ──────────────────────────────────────────────────────────────
+WorkerPool::WorkerPool(unsigned workers) {
+    if (workers == 0) workers = 1;
+    threads_.reserve(workers - 1);
+    for (unsigned i = 1; i < workers; ++i) threads_.emplace_back(&WorkerPool::worker_loop, this);
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& t : threads_) t.join();
+}
+
+WorkerPool& WorkerPool::shared() {
+    static WorkerPool pool;
+    return pool;
+}
+
+void WorkerPool::drain() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (next_task_ < tasks_) {
+        std::size_t i = next_task_++;
+        lock.unlock();
+        (*job_)(i);
+        lock.lock();
+        if (--pending_ == 0) done_cv_.notify_all();
+    }
+}
+
+void WorkerPool::worker_loop() {
+    std::uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            start_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+        }
+        drain();
+    }
+}
+
+void WorkerPool::parallel_for(std::size_t tasks, const std::function<void(std::size_t)>& fn) {
+    if (tasks == 0) return;
+    std::lock_guard<std::mutex> run_lock(run_mtx_);
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        job_ = &fn;
+        tasks_ = tasks;
+        next_task_ = 0;
+        pending_ = tasks;
+        ++generation_;
+    }
+    start_cv_.notify_all();
+    drain();
+    std::unique_lock<std::mutex> lock(mtx_);
+    done_cv_.wait(lock, [&] { return pending_ == 0; });
+    job_ = nullptr;
+}
+
+// ── Reductions ──────────────────────────────────────────────────────────────
+namespace {
+
+WorkerPool& pool_of(const ParallelOptions& opts) {
+    return opts.pool ? *opts.pool : WorkerPool::shared();
+}
+
+std::size_t chunk_count(std::size_t n, const ParallelOptions& opts) {
+    std::size_t chunk = std::max<std::size_t>(opts.chunk_elements, 1);
+    return (n + chunk - 1) / chunk;
+}
+
+// Runs fn(begin, end) for every chunk and returns the per-chunk results.
+template <typename Fn>
+std::vector<double> map_chunks(const std::vector<double>& data, const ParallelOptions& opts, Fn fn) {
+    std::size_t chunk = std::max<std::size_t>(opts.chunk_elements, 1);
+    std::vector<double> partial(chunk_count(data.size(), opts));
+    pool_of(opts).parallel_for(partial.size(), [&](std::size_t c) {
+        std::size_t begin = c * chunk;
+        std::size_t end = std::min(begin + chunk, data.size());
+        partial[c] = fn(data.data() + begin, end - begin);
+    });
+    return partial;
+}
+
+double pairwise_sum(std::vector<double>& v) {
+    for (std::size_t width = 1; width < v.size(); width *= 2) {
+        for (std::size_t i = 0; i + width < v.size(); i += 2 * width) v[i] += v[i + width];
+    }
+    return v.empty() ? 0.0 : v[0];
+}
+
+bool use_serial(std::size_t n, const ParallelOptions& opts) {
+    return n < opts.serial_threshold || pool_of(opts).size() == 1;
+}
+
+// Monotonic mapping of doubles to unsigned keys (NaNs excluded).
+std::uint64_t order_key(double v) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return (bits & 0x8000000000000000ull) ? ~bits : (bits | 0x8000000000000000ull);
+}
+
+// Value of rank k (0-based) in data, by most-significant-digit radix
+// select over order_key() with 11-bit digits.
+double parallel_select(const std::vector<double>& data, std::size_t k, const ParallelOptions& opts) {
+    constexpr int kDigitBits = 11;
+    constexpr std::size_t kBuckets = std::size_t{1} << kDigitBits;
+    constexpr std::size_t kGatherLimit = 1u << 16;
+
+    // Histogram passes use a few large slices per worker rather than the
+    // cache-sized chunks, so the per-task histograms stay small in total.
+    WorkerPool& pool = pool_of(opts);
+    std::size_t chunks = std::min<std::size_t>(chunk_count(data.size(), opts), pool.size() * 4);
+    std::size_t chunk = (data.size() + chunks - 1) / chunks;
+
+    std::uint64_t prefix = 0;   // key bits fixed so far
+    int fixed_bits = 0;         // how many leading bits of prefix are fixed
+    std::size_t candidates = data.size();
+
+    auto matches = [&](std::uint64_t key) {
+        return fixed_bits == 0 || (key >> (64 - fixed_bits)) == (prefix >> (64 - fixed_bits));
+    };
+
+    while (candidates > kGatherLimit && fixed_bits < 64) {
+        int shift = std::max(64 - fixed_bits - kDigitBits, 0);
+        int bits = 64 - fixed_bits - shift;
+        std::size_t buckets = std::size_t{1} << bits;
+        std::vector<std::array<std::size_t, kBuckets>> hist(chunks);
+        pool.parallel_for(chunks, [&](std::size_t c) {
+            auto& h = hist[c];
+            h.fill(0);
+            std::size_t end = std::min((c + 1) * chunk, data.size());
+            for (std::size_t i = c * chunk; i < end; ++i) {
+                std::uint64_t key = order_key(data[i]);
+                if (matches(key)) ++h[(key >> shift) & (buckets - 1)];
+            }
+        });
+        std::size_t b = 0;
+        for (; b < buckets; ++b) {
+            std::size_t count = 0;
+            for (const auto& h : hist) count += h[b];
+            if (k < count) {
+                candidates = count;
+                break;
+            }
+            k -= count;
+        }
+        prefix |= static_cast<std::uint64_t>(b) << shift;
+        fixed_bits += bits;
+    }
+
+    if (fixed_bits >= 64) {
+        // Every remaining candidate has the same key, hence the same value.
+        std::uint64_t key = prefix;
+        std::uint64_t bits = (key & 0x8000000000000000ull) ? (key & ~0x8000000000000000ull) : ~key;
+        double v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+
+    std::vector<std::vector<double>> found(chunks);
+    pool.parallel_for(chunks, [&](std::size_t c) {
+        std::size_t end = std::min((c + 1) * chunk, data.size());
+        for (std::size_t i = c * chunk; i < end; ++i) {
+            if (matches(order_key(data[i]))) found[c].push_back(data[i]);
+        }
+    });
+    std::vector<double> rest;
+    rest.reserve(candidates);
+    for (const auto& f : found) rest.insert(rest.end(), f.begin(), f.end());
+    auto nth = rest.begin() + static_cast<std::ptrdiff_t>(k);
+    std::nth_element(rest.begin(), nth, rest.end());
+    return *nth;
+}
+
+}  // namespace
+
+double parallel_mean(const std::vector<double>& data, const ParallelOptions& opts) {
+    if (data.empty()) throw std::invalid_argument("empty data");
+    if (use_serial(data.size(), opts)) return mean(data);
+    auto partial = map_chunks(data, opts, [](const double* p, std::size_t n) { return simd::sum(p, n); });
+    return pairwise_sum(partial) / static_cast<double>(data.size());
+}
+
+double parallel_standard_deviation(const std::vector<double>& data, const ParallelOptions& opts) {
+    if (data.size() < 2) throw std::invalid_argument("need at least 2 values");
+    if (use_serial(data.size(), opts)) return standard_deviation(data);
+    double m = parallel_mean(data, opts);
+    auto partial = map_chunks(data, opts, [m](const double* p, std::size_t n) {
+        return simd::sum_sq_dev(p, n, m);
+    });
+    return std::sqrt(pairwise_sum(partial) / static_cast<double>(data.size() - 1));
+}
+
+double parallel_median(const std::vector<double>& data, const ParallelOptions& opts) {
+    if (data.empty()) throw std::invalid_argument("empty data");
+    if (use_serial(data.size(), opts)) return median(data);
+    std::size_t n = data.size();
+    double upper = parallel_select(data, n / 2, opts);
+    if (n % 2 == 1) return upper;
+    return (parallel_select(data, n / 2 - 1, opts) + upper) / 2.0;
+}
+
+}  // namespace mathlib
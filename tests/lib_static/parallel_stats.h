@@ -0,0 +1,74 @@
+// Static library: multi-threaded reductions for large datasets
+#ifndef PARALLEL_STATS_H
+#define PARALLEL_STATS_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mathlib {
+
+// CPU count of the target: _syspage_ptr->num_cpu on QNX,
+// std::thread::hardware_concurrency() elsewhere (at least 1).
+unsigned default_worker_count();
+
+// Fixed set of worker threads that run index-parallel jobs. The calling
+// thread takes part, so a pool of size N starts N - 1 threads. Jobs from
+// different callers are serialized.
+class WorkerPool {
+public:
+    explicit WorkerPool(unsigned workers = default_worker_count());
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(threads_.size()) + 1; }
+
+    // Calls fn(i) for every i in [0, tasks), tasks handed out dynamically.
+    void parallel_for(std::size_t tasks, const std::function<void(std::size_t)>& fn);
+
+    // Process-wide pool sized with default_worker_count().
+    static WorkerPool& shared();
+
+private:
+    void worker_loop();
+    void drain();
+
+    std::vector<std::thread> threads_;
+    std::mutex run_mtx_;
+    std::mutex mtx_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(std::size_t)>* job_ = nullptr;
+    std::size_t tasks_ = 0;
+    std::size_t next_task_ = 0;
+    std::size_t pending_ = 0;
+    std::uint64_t generation_ = 0;
+    bool stop_ = false;
+};
+
+struct ParallelOptions {
+    WorkerPool* pool = nullptr;                  // nullptr: WorkerPool::shared()
+    std::size_t serial_threshold = 1u << 18;     // below this, use the serial path
+    std::size_t chunk_elements = 1u << 15;       // 256 KB of doubles per task
+};
+
+// Parallel counterparts of mean(), standard_deviation() and median(), with
+// the same contracts. Per-chunk sums come from the SIMD kernels and chunk
+// partials are combined by pairwise summation, so rounding error grows
+// with log(number of chunks) instead of the element count.
+double parallel_mean(const std::vector<double>& data, const ParallelOptions& opts = {});
+double parallel_standard_deviation(const std::vector<double>& data, const ParallelOptions& opts = {});
+// Does not modify or copy `data`: radix-selects on the ordered bit
+// pattern of the doubles with parallel histograms, then finishes with
+// nth_element on the few remaining candidates.
+double parallel_median(const std::vector<double>& data, const ParallelOptions& opts = {});
+
+}  // namespace mathlib
+
+#endif  // PARALLEL_STATS_H
@@ -0,0 +1,73 @@
+// Streaming statistics implementation
+#include "running_stats.h"
+#include "simd_kernels.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace mathlib {
+
+void RunningStats::push(double value) {
+    if (count_ == 0) {
+        min_ = max_ = value;
+    } else {
+        if (value < min_) min_ = value;
+        if (value > max_) max_ = value;
+    }
+    ++count_;
+    double delta = value - mean_;
+    mean_ += delta / static_cast<double>(count_);
+    m2_ += delta * (value - mean_);
+}
+
+void RunningStats::push(const double* data, std::size_t n) {
+    if (n == 0) return;
+    RunningStats block;
+    block.count_ = n;
+    block.mean_ = simd::sum(data, n) / static_cast<double>(n);
+    block.m2_ = simd::sum_sq_dev(data, n, block.mean_);
+    simd::min_max(data, n, &block.min_, &block.max_);
+    merge(block);
+}
+
+void RunningStats::merge(const RunningStats& other) {
+    if (other.count_ == 0) return;
+    if (count_ == 0) {
+        *this = other;
+        return;
+    }
+    double n_a = static_cast<double>(count_);
+    double n_b = static_cast<double>(other.count_);
+    double n = n_a + n_b;
+    double delta = other.mean_ - mean_;
+    mean_ += delta * (n_b / n);
+    m2_ += other.m2_ + delta * delta * (n_a * n_b / n);
+    count_ += other.count_;
+    if (other.min_ < min_) min_ = other.min_;
+    if (other.max_ > max_) max_ = other.max_;
+}
+
+void RunningStats::reset() { *this = RunningStats{}; }
+
+double RunningStats::mean() const {
+    if (count_ == 0) throw std::invalid_argument("empty data");
+    return mean_;
+}
+
+double RunningStats::variance() const {
+    if (count_ < 2) throw std::invalid_argument("need at least 2 values");
+    return m2_ / static_cast<double>(count_ - 1);
+}
+
+double RunningStats::standard_deviation() const { return std::sqrt(variance()); }
+
+double RunningStats::min() const {
+    if (count_ == 0) throw std::invalid_argument("empty data");
+    return min_;
+}
+
+double RunningStats::max() const {
+    if (count_ == 0) throw std::invalid_argument("empty data");
+    return max_;
+}
+
+}  // namespace mathlib
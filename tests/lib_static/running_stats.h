@@ -0,0 +1,42 @@
+// Static library: single-pass streaming statistics (Welford / Chan et al.)
+#ifndef RUNNING_STATS_H
+#define RUNNING_STATS_H
+
+#include <cstddef>
+
+namespace mathlib {
+
+// Accumulates count/mean/variance/min/max one sample at a time in O(1)
+// memory. Partial accumulators built on separate threads can be combined
+// with merge() once the threads are done; the class itself is not
+// synchronized.
+class RunningStats {
+public:
+    void push(double value);
+    // Adds a block of samples using the SIMD kernels, then merges it in.
+    void push(const double* data, std::size_t n);
+    void merge(const RunningStats& other);
+    void reset();
+
+    std::size_t count() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    // Same contracts as the free functions in mathlib.h: throw
+    // std::invalid_argument when there are too few samples.
+    double mean() const;
+    double variance() const;            // sample variance (n - 1)
+    double standard_deviation() const;
+    double min() const;
+    double max() const;
+
+private:
+    std::size_t count_ = 0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;  // sum of squared deviations from the running mean
+    double min_ = 0.0;
+    double max_ = 0.0;
+};
+
+}  // namespace mathlib
+
+#endif  // RUNNING_STATS_H
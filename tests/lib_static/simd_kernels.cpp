@@ -0,0 +1,390 @@
+// Vectorized reduction kernels
+//
+// The x86_64 kernels are compiled with per-function target attributes so
+// the library itself needs no -mavx2 / -mavx512f copts and still runs on
+// CPUs without those extensions. NEON is part of the aarch64 baseline.
+#include "simd_kernels.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace mathlib {
+namespace simd {
+
+namespace {
+
+// ── Scalar reference ────────────────────────────────────────────────────────
+double scalar_sum(const double* data, std::size_t n) {
+    double s = 0.0;
+    for (std::size_t i = 0; i < n; ++i) s += data[i];
+    return s;
+}
+
+double scalar_sum_sq_dev(const double* data, std::size_t n, double center) {
+    double s = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        double d = data[i] - center;
+        s += d * d;
+    }
+    return s;
+}
+
+void scalar_min_max(const double* data, std::size_t n, double* min_out, double* max_out) {
+    double lo = data[0], hi = data[0];
+    for (std::size_t i = 1; i < n; ++i) {
+        if (data[i] < lo) lo = data[i];
+        if (data[i] > hi) hi = data[i];
+    }
+    *min_out = lo;
+    *max_out = hi;
+}
+
+double scalar_dot(const double* a, const double* b, std::size_t n) {
+    double s = 0.0;
+    for (std::size_t i = 0; i < n; ++i) s += a[i] * b[i];
+    return s;
+}
+
+const Kernels kScalar = {Isa::Scalar, scalar_sum, scalar_sum_sq_dev, scalar_min_max, scalar_dot};
+
+#if defined(__x86_64__)
+// ── AVX2 (4 doubles per register, 4 independent accumulators) ─────────────
+#define MATHLIB_AVX2 __attribute__((target("avx2,fma")))
+
+MATHLIB_AVX2 double hsum256(__m256d v) {
+    __m128d lo = _mm256_castpd256_pd128(v);
+    __m128d hi = _mm256_extractf128_pd(v, 1);
+    lo = _mm_add_pd(lo, hi);
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+MATHLIB_AVX2 double avx2_sum(const double* data, std::size_t n) {
+    __m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        a0 = _mm256_add_pd(a0, _mm256_loadu_pd(data + i));
+        a1 = _mm256_add_pd(a1, _mm256_loadu_pd(data + i + 4));
+        a2 = _mm256_add_pd(a2, _mm256_loadu_pd(data + i + 8));
+        a3 = _mm256_add_pd(a3, _mm256_loadu_pd(data + i + 12));
+    }
+    for (; i + 4 <= n; i += 4) a0 = _mm256_add_pd(a0, _mm256_loadu_pd(data + i));
+    double s = hsum256(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+    for (; i < n; ++i) s += data[i];
+    return s;
+}
+
+MATHLIB_AVX2 double avx2_sum_sq_dev(const double* data, std::size_t n, double center) {
+    const __m256d c = _mm256_set1_pd(center);
+    __m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256d d0 = _mm256_sub_pd(_mm256_loadu_pd(data + i), c);
+        __m256d d1 = _mm256_sub_pd(_mm256_loadu_pd(data + i + 4), c);
+        __m256d d2 = _mm256_sub_pd(_mm256_loadu_pd(data + i + 8), c);
+        __m256d d3 = _mm256_sub_pd(_mm256_loadu_pd(data + i + 12), c);
+        a0 = _mm256_fmadd_pd(d0, d0, a0);
+        a1 = _mm256_fmadd_pd(d1, d1, a1);
+        a2 = _mm256_fmadd_pd(d2, d2, a2);
+        a3 = _mm256_fmadd_pd(d3, d3, a3);
+    }
+    for (; i + 4 <= n; i += 4) {
+        __m256d d = _mm256_sub_pd(_mm256_loadu_pd(data + i), c);
+        a0 = _mm256_fmadd_pd(d, d, a0);
+    }
+    double s = hsum256(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+    for (; i < n; ++i) {
+        double d = data[i] - center;
+        s += d * d;
+    }
+    return s;
+}
+
+MATHLIB_AVX2 void avx2_min_max(const double* data, std::size_t n, double* min_out, double* max_out) {
+    if (n < 8) {
+        scalar_min_max(data, n, min_out, max_out);
+        return;
+    }
+    __m256d lo0 = _mm256_loadu_pd(data), hi0 = lo0;
+    __m256d lo1 = _mm256_loadu_pd(data + 4), hi1 = lo1;
+    std::size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        __m256d v0 = _mm256_loadu_pd(data + i);
+        __m256d v1 = _mm256_loadu_pd(data + i + 4);
+        lo0 = _mm256_min_pd(lo0, v0);
+        hi0 = _mm256_max_pd(hi0, v0);
+        lo1 = _mm256_min_pd(lo1, v1);
+        hi1 = _mm256_max_pd(hi1, v1);
+    }
+    alignas(32) double lo[4], hi[4];
+    _mm256_store_pd(lo, _mm256_min_pd(lo0, lo1));
+    _mm256_store_pd(hi, _mm256_max_pd(hi0, hi1));
+    double mn = lo[0], mx = hi[0];
+    for (int k = 1; k < 4; ++k) {
+        if (lo[k] < mn) mn = lo[k];
+        if (hi[k] > mx) mx = hi[k];
+    }
+    for (; i < n; ++i) {
+        if (data[i] < mn) mn = data[i];
+        if (data[i] > mx) mx = data[i];
+    }
+    *min_out = mn;
+    *max_out = mx;
+}
+
+MATHLIB_AVX2 double avx2_dot(const double* a, const double* b, std::size_t n) {
+    __m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        a0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), a0);
+        a1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), a1);
+        a2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8), a2);
+        a3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12), a3);
+    }
+    for (; i + 4 <= n; i += 4) {
+        a0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), a0);
+    }
+    double s = hsum256(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+    for (; i < n; ++i) s += a[i] * b[i];
+    return s;
+}
+
+const Kernels kAvx2 = {Isa::AVX2, avx2_sum, avx2_sum_sq_dev, avx2_min_max, avx2_dot};
+
+// ── AVX-512F (8 doubles per register, masked tail) ──────────────────────────
+#define MATHLIB_AVX512 __attribute__((target("avx512f")))
+
+// GCC 12's unmasked min/max and _mm512_reduce_* intrinsics trip
+// -Wmaybe-uninitialized inside the intrinsic headers, so use the
+// full-mask forms and reduce through memory instead.
+MATHLIB_AVX512 __m512d min512(__m512d a, __m512d b) {
+    return _mm512_mask_min_pd(a, static_cast<__mmask8>(0xFF), a, b);
+}
+
+MATHLIB_AVX512 __m512d max512(__m512d a, __m512d b) {
+    return _mm512_mask_max_pd(a, static_cast<__mmask8>(0xFF), a, b);
+}
+
+MATHLIB_AVX512 double hsum512(__m512d v) {
+    alignas(64) double lanes[8];
+    _mm512_store_pd(lanes, v);
+    return ((lanes[0] + lanes[4]) + (lanes[1] + lanes[5])) +
+           ((lanes[2] + lanes[6]) + (lanes[3] + lanes[7]));
+}
+
+MATHLIB_AVX512 double avx512_sum(const double* data, std::size_t n) {
+    __m512d a0 = _mm512_setzero_pd(), a1 = a0;
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        a0 = _mm512_add_pd(a0, _mm512_loadu_pd(data + i));
+        a1 = _mm512_add_pd(a1, _mm512_loadu_pd(data + i + 8));
+    }
+    if (i < n) {
+        __mmask8 m = static_cast<__mmask8>((1u << ((n - i) < 8 ? (n - i) : 8)) - 1);
+        a0 = _mm512_add_pd(a0, _mm512_maskz_loadu_pd(m, data + i));
+        i += 8;
+        if (i < n) {
+            m = static_cast<__mmask8>((1u << (n - i)) - 1);
+            a1 = _mm512_add_pd(a1, _mm512_maskz_loadu_pd(m, data + i));
+        }
+    }
+    return hsum512(_mm512_add_pd(a0, a1));
+}
+
+MATHLIB_AVX512 double avx512_sum_sq_dev(const double* data, std::size_t n, double center) {
+    const __m512d c = _mm512_set1_pd(center);
+    __m512d a0 = _mm512_setzero_pd(), a1 = a0;
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512d d0 = _mm512_sub_pd(_mm512_loadu_pd(data + i), c);
+        __m512d d1 = _mm512_sub_pd(_mm512_loadu_pd(data + i + 8), c);
+        a0 = _mm512_fmadd_pd(d0, d0, a0);
+        a1 = _mm512_fmadd_pd(d1, d1, a1);
+    }
+    for (; i < n; i += 8) {
+        std::size_t left = n - i < 8 ? n - i : 8;
+        __mmask8 m = static_cast<__mmask8>((1u << left) - 1);
+        __m512d d = _mm512_maskz_sub_pd(m, _mm512_maskz_loadu_pd(m, data + i), c);
+        a0 = _mm512_fmadd_pd(d, d, a0);
+    }
+    return hsum512(_mm512_add_pd(a0, a1));
+}
+
+MATHLIB_AVX512 void avx512_min_max(const double* data, std::size_t n, double* min_out, double* max_out) {
+    if (n < 8) {
+        scalar_min_max(data, n, min_out, max_out);
+        return;
+    }
+    __m512d lo = _mm512_loadu_pd(data), hi = lo;
+    std::size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        __m512d v = _mm512_loadu_pd(data + i);
+        lo = min512(lo, v);
+        hi = max512(hi, v);
+    }
+    if (i < n) {
+        // Re-read the last full vector; overlap is harmless for min/max.
+        __m512d v = _mm512_loadu_pd(data + n - 8);
+        lo = min512(lo, v);
+        hi = max512(hi, v);
+    }
+    alignas(64) double lo_lanes[8], hi_lanes[8];
+    _mm512_store_pd(lo_lanes, lo);
+    _mm512_store_pd(hi_lanes, hi);
+    double mn = lo_lanes[0], mx = hi_lanes[0];
+    for (int k = 1; k < 8; ++k) {
+        if (lo_lanes[k] < mn) mn = lo_lanes[k];
+        if (hi_lanes[k] > mx) mx = hi_lanes[k];
+    }
+    *min_out = mn;
+    *max_out = mx;
+}
+
+MATHLIB_AVX512 double avx512_dot(const double* a, const double* b, std::size_t n) {
+    __m512d a0 = _mm512_setzero_pd(), a1 = a0;
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        a0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), a0);
+        a1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), a1);
+    }
+    for (; i < n; i += 8) {
+        std::size_t left = n - i < 8 ? n - i : 8;
+        __mmask8 m = static_cast<__mmask8>((1u << left) - 1);
+        a0 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i), a0);
+    }
+    return hsum512(_mm512_add_pd(a0, a1));
+}
+
+const Kernels kAvx512 = {Isa::AVX512, avx512_sum, avx512_sum_sq_dev, avx512_min_max, avx512_dot};
+
+#elif defined(__aarch64__)
+// ── NEON (2 doubles per register, 4 independent accumulators) ──────────────
+double neon_sum(const double* data, std::size_t n) {
+    float64x2_t a0 = vdupq_n_f64(0.0), a1 = a0, a2 = a0, a3 = a0;
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        a0 = vaddq_f64(a0, vld1q_f64(data + i));
+        a1 = vaddq_f64(a1, vld1q_f64(data + i + 2));
+        a2 = vaddq_f64(a2, vld1q_f64(data + i + 4));
+        a3 = vaddq_f64(a3, vld1q_f64(data + i + 6));
+    }
+    double s = vaddvq_f64(vaddq_f64(vaddq_f64(a0, a1), vaddq_f64(a2, a3)));
+    for (; i < n; ++i) s += data[i];
+    return s;
+}
+
+double neon_sum_sq_dev(const double* data, std::size_t n, double center) {
+    const float64x2_t c = vdupq_n_f64(center);
+    float64x2_t a0 = vdupq_n_f64(0.0), a1 = a0, a2 = a0, a3 = a0;
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        float64x2_t d0 = vsubq_f64(vld1q_f64(data + i), c);
+        float64x2_t d1 = vsubq_f64(vld1q_f64(data + i + 2), c);
+        float64x2_t d2 = vsubq_f64(vld1q_f64(data + i + 4), c);
+        float64x2_t d3 = vsubq_f64(vld1q_f64(data + i + 6), c);
+        a0 = vfmaq_f64(a0, d0, d0);
+        a1 = vfmaq_f64(a1, d1, d1);
+        a2 = vfmaq_f64(a2, d2, d2);
+        a3 = vfmaq_f64(a3, d3, d3);
+    }
+    double s = vaddvq_f64(vaddq_f64(vaddq_f64(a0, a1), vaddq_f64(a2, a3)));
+    for (; i < n; ++i) {
+        double d = data[i] - center;
+        s += d * d;
+    }
+    return s;
+}
+
+void neon_min_max(const double* data, std::size_t n, double* min_out, double* max_out) {
+    if (n < 4) {
+        scalar_min_max(data, n, min_out, max_out);
+        return;
+    }
+    float64x2_t lo0 = vld1q_f64(data), hi0 = lo0;
+    float64x2_t lo1 = vld1q_f64(data + 2), hi1 = lo1;
+    std::size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        float64x2_t v0 = vld1q_f64(data + i);
+        float64x2_t v1 = vld1q_f64(data + i + 2);
+        lo0 = vminq_f64(lo0, v0);
+        hi0 = vmaxq_f64(hi0, v0);
+        lo1 = vminq_f64(lo1, v1);
+        hi1 = vmaxq_f64(hi1, v1);
+    }
+    double mn = vminvq_f64(vminq_f64(lo0, lo1));
+    double mx = vmaxvq_f64(vmaxq_f64(hi0, hi1));
+    for (; i < n; ++i) {
+        if (data[i] < mn) mn = data[i];
+        if (data[i] > mx) mx = data[i];
+    }
+    *min_out = mn;
+    *max_out = mx;
+}
+
+double neon_dot(const double* a, const double* b, std::size_t n) {
+    float64x2_t a0 = vdupq_n_f64(0.0), a1 = a0, a2 = a0, a3 = a0;
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        a0 = vfmaq_f64(a0, vld1q_f64(a + i), vld1q_f64(b + i));
+        a1 = vfmaq_f64(a1, vld1q_f64(a + i + 2), vld1q_f64(b + i + 2));
+        a2 = vfmaq_f64(a2, vld1q_f64(a + i + 4), vld1q_f64(b + i + 4));
+        a3 = vfmaq_f64(a3, vld1q_f64(a + i + 6), vld1q_f64(b + i + 6));
+    }
+    double s = vaddvq_f64(vaddq_f64(vaddq_f64(a0, a1), vaddq_f64(a2, a3)));
+    for (; i < n; ++i) s += a[i] * b[i];
+    return s;
+}
+
+const Kernels kNeon = {Isa::NEON, neon_sum, neon_sum_sq_dev, neon_min_max, neon_dot};
+#endif
+
+const Kernels& select_kernels() {
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return kAvx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return kAvx2;
+#elif defined(__aarch64__)
+    return kNeon;
+#endif
+    return kScalar;
+}
+
+}  // namespace
+
+const Kernels& kernels() {
+    static const Kernels& selected = select_kernels();
+    return selected;
+}
+
+const Kernels* kernels_for(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar: return &kScalar;
+#if defined(__x86_64__)
+        case Isa::AVX2:
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return &kAvx2;
+            return nullptr;
+        case Isa::AVX512:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx512f") ? &kAvx512 : nullptr;
+#elif defined(__aarch64__)
+        case Isa::NEON: return &kNeon;
+#endif
+        default: return nullptr;
+    }
+}
+
+const char* isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar: return "scalar";
+        case Isa::AVX2:   return "avx2";
+        case Isa::AVX512: return "avx512";
+        case Isa::NEON:   return "neon";
+    }
+    return "unknown";
+}
+
+}  // namespace simd
+}  // namespace mathlib
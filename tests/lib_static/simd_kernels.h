@@ -0,0 +1,48 @@
+// Static library: vectorized reduction kernels with runtime CPU dispatch
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <cstddef>
+
+namespace mathlib {
+namespace simd {
+
+enum class Isa { Scalar, AVX2, AVX512, NEON };
+
+// One table per instruction set. All kernels require n > 0 except sum,
+// sum_sq_dev and dot, which return 0 for n == 0. Results of the
+// floating-point reductions differ from a sequential loop only by
+// summation order; min_max is exact. NaN handling is unspecified.
+struct Kernels {
+    Isa isa;
+    double (*sum)(const double* data, std::size_t n);
+    // Sum of (x - center)^2; center = 0 gives the plain sum of squares.
+    double (*sum_sq_dev)(const double* data, std::size_t n, double center);
+    void (*min_max)(const double* data, std::size_t n, double* min_out, double* max_out);
+    double (*dot)(const double* a, const double* b, std::size_t n);
+};
+
+// Best kernel set for the running CPU, selected once on first use.
+const Kernels& kernels();
+
+// Kernel set for a specific ISA, or nullptr when this build or CPU cannot
+// run it. Intended for tests and benchmarks.
+const Kernels* kernels_for(Isa isa);
+
+const char* isa_name(Isa isa);
+
+inline double sum(const double* data, std::size_t n) { return kernels().sum(data, n); }
+inline double sum_sq_dev(const double* data, std::size_t n, double center) {
+    return kernels().sum_sq_dev(data, n, center);
+}
+inline void min_max(const double* data, std::size_t n, double* min_out, double* max_out) {
+    kernels().min_max(data, n, min_out, max_out);
+}
+inline double dot(const double* a, const double* b, std::size_t n) {
+    return kernels().dot(a, b, n);
+}
+
+}  // namespace simd
+}  // namespace mathlib
+
+#endif  // SIMD_KERNELS_H
@@ -0,0 +1,99 @@
+// Sliding-window statistics implementation
+#include "sliding_window.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace mathlib {
+
+SlidingWindow::SlidingWindow(std::size_t capacity, std::chrono::nanoseconds max_age)
+    : capacity_(capacity), max_age_(max_age) {
+    if (capacity == 0) throw std::invalid_argument("window capacity must be positive");
+    slots_.reset(new Slot[capacity]);
+}
+
+void SlidingWindow::pop_oldest() {
+    double x = slot(head_seq_).value;
+    if (slot(min_front_).min_seq == head_seq_) ++min_front_;
+    if (slot(max_front_).max_seq == head_seq_) ++max_front_;
+    ++head_seq_;
+    --size_;
+    if (size_ == 0) {
+        mean_ = 0.0;
+        m2_ = 0.0;
+        return;
+    }
+    double delta = x - mean_;
+    mean_ -= delta / static_cast<double>(size_);
+    m2_ -= delta * (x - mean_);
+    if (m2_ < 0.0) m2_ = 0.0;
+}
+
+void SlidingWindow::expire(clock::time_point now) {
+    if (max_age_ == std::chrono::nanoseconds::zero()) return;
+    while (size_ > 0 && now - slot(head_seq_).when > max_age_) pop_oldest();
+}
+
+void SlidingWindow::push(double value, clock::time_point when) {
+    if (size_ == capacity_) pop_oldest();
+    expire(when);
+
+    std::uint64_t seq = next_seq_++;
+    Slot& s = slot(seq);
+    s.value = value;
+    s.when = when;
+    ++size_;
+
+    // Deque positions are sequence-like counters too; both deques hold at
+    // most `capacity_` entries, so they can share the slot ring.
+    while (min_back_ > min_front_ && slot(slot(min_back_ - 1).min_seq).value >= value) --min_back_;
+    slot(min_back_++).min_seq = seq;
+    while (max_back_ > max_front_ && slot(slot(max_back_ - 1).max_seq).value <= value) --max_back_;
+    slot(max_back_++).max_seq = seq;
+
+    double delta = value - mean_;
+    mean_ += delta / static_cast<double>(size_);
+    m2_ += delta * (value - mean_);
+}
+
+void SlidingWindow::clear() {
+    head_seq_ = next_seq_ = 0;
+    size_ = 0;
+    min_front_ = min_back_ = max_front_ = max_back_ = 0;
+    mean_ = m2_ = 0.0;
+}
+
+void SlidingWindow::recompute() {
+    mean_ = m2_ = 0.0;
+    std::size_t n = 0;
+    for (std::uint64_t seq = head_seq_; seq < next_seq_; ++seq) {
+        double x = slot(seq).value;
+        ++n;
+        double delta = x - mean_;
+        mean_ += delta / static_cast<double>(n);
+        m2_ += delta * (x - mean_);
+    }
+}
+
+double SlidingWindow::mean() const {
+    if (size_ == 0) throw std::invalid_argument("empty data");
+    return mean_;
+}
+
+double SlidingWindow::variance() const {
+    if (size_ < 2) throw std::invalid_argument("need at least 2 values");
+    return m2_ / static_cast<double>(size_ - 1);
+}
+
+double SlidingWindow::standard_deviation() const { return std::sqrt(variance()); }
+
+double SlidingWindow::min() const {
+    if (size_ == 0) throw std::invalid_argument("empty data");
+    return slot(slot(min_front_).min_seq).value;
+}
+
+double SlidingWindow::max() const {
+    if (size_ == 0) throw std::invalid_argument("empty data");
+    return slot(slot(max_front_).max_seq).value;
+}
+
+}  // namespace mathlib
@@ -0,0 +1,77 @@
+// Static library: O(1) sliding-window statistics
+#ifndef SLIDING_WINDOW_H
+#define SLIDING_WINDOW_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace mathlib {
+
+// Mean/variance/min/max over the most recent `capacity` samples and,
+// optionally, only those no older than `max_age`. All state lives in one
+// buffer allocated by the constructor: a ring of samples plus two
+// monotonic deques (for min and max) stored alongside it, so push() never
+// allocates and runs in O(1) amortized time.
+//
+// Mean and variance are maintained with Welford add/remove updates rather
+// than raw sums to limit cancellation; call recompute() to resynchronize
+// them exactly from the stored samples if a window runs for a very long
+// time over data with a large dynamic range.
+class SlidingWindow {
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit SlidingWindow(std::size_t capacity,
+                           std::chrono::nanoseconds max_age = std::chrono::nanoseconds::zero());
+
+    void push(double value) { push(value, clock::now()); }
+    void push(double value, clock::time_point when);
+    // Drops samples older than max_age relative to `now` (no-op without
+    // a max_age). push() already expires relative to the new sample.
+    void expire(clock::time_point now);
+    void clear();
+    void recompute();
+
+    std::size_t size() const { return size_; }
+    std::size_t capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+
+    // Throw std::invalid_argument when there are too few samples.
+    double mean() const;
+    double variance() const;  // sample variance (n - 1)
+    double standard_deviation() const;
+    double min() const;
+    double max() const;
+
+private:
+    struct Slot {
+        double value;
+        clock::time_point when;
+        std::uint64_t min_seq;  // min deque storage (ring)
+        std::uint64_t max_seq;  // max deque storage (ring)
+    };
+
+    Slot& slot(std::uint64_t seq) const { return slots_[seq % capacity_]; }
+    void pop_oldest();
+
+    std::size_t capacity_;
+    std::chrono::nanoseconds max_age_;
+    std::unique_ptr<Slot[]> slots_;
+
+    std::uint64_t head_seq_ = 0;  // oldest live sample
+    std::uint64_t next_seq_ = 0;  // sequence number of the next push
+    std::size_t size_ = 0;
+
+    // Deques hold sample sequence numbers in [front, back) positions.
+    std::uint64_t min_front_ = 0, min_back_ = 0;
+    std::uint64_t max_front_ = 0, max_back_ = 0;
+
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+};
+
+}  // namespace mathlib
+
+#endif  // SLIDING_WINDOW_H
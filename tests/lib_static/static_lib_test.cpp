@@ -2,7 +2,56 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <thread>
+#include <random>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <stdexcept>
+#include <unistd.h>
 #include "mathlib.h"
+#include "running_stats.h"
+#include "kll_sketch.h"
+#include "histogram.h"
+#include "sliding_window.h"
+#include "stats_view.h"
+#include "parallel_stats.h"
+#include "column_file.h"
+#include "simd_kernels.h"
+
+// Compares one SIMD kernel table against the scalar reference. Sums may
+// differ by reassociation only, so allow a relative error of n * epsilon;
+// min/max must match bit for bit.
+bool check_kernels(const mathlib::simd::Kernels& k) {
+    const auto& ref = *mathlib::simd::kernels_for(mathlib::simd::Isa::Scalar);
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> dist(-1000.0, 1000.0);
+    for (size_t n : {1, 3, 7, 8, 15, 16, 17, 33, 1000, 1003}) {
+        std::vector<double> a(n), b(n);
+        for (size_t i = 0; i < n; ++i) { a[i] = dist(rng); b[i] = dist(rng); }
+        double abs_sum = 0.0;
+        for (double v : a) abs_sum += std::fabs(v);
+        double tol = static_cast<double>(n) * 1e-16;
+        auto close = [tol](double x, double y, double scale) {
+            return std::fabs(x - y) <= tol * scale + 1e-300;
+        };
+        double mn, mx, rmn, rmx;
+        k.min_max(a.data(), n, &mn, &mx);
+        ref.min_max(a.data(), n, &rmn, &rmx);
+        double sq = ref.sum_sq_dev(a.data(), n, 1.5);
+        if (!close(k.sum(a.data(), n), ref.sum(a.data(), n), abs_sum) ||
+            !close(k.sum_sq_dev(a.data(), n, 1.5), sq, sq) ||
+            !close(k.dot(a.data(), b.data(), n), ref.dot(a.data(), b.data(), n), 1e3 * abs_sum) ||
+            mn != rmn || mx != rmx) {
+            std::cout << "  " << mathlib::simd::isa_name(k.isa) << " mismatch at n=" << n << "\n";
+            return false;
+        }
+    }
+    return true;
+}
 
 int main() {
     std::cout << "=== Static library test ===\n";
@@ -25,6 +74,242 @@ int main() {
     std::cout << "stddev = " << mathlib::standard_deviation(data) << "\n";
     std::cout << "median = " << mathlib::median(data) << "\n";
 
+    // Selection-based quantiles, checked against a full sort
+    {
+        std::vector<double> latencies(10007);
+        std::mt19937_64 rng(7);
+        std::exponential_distribution<double> dist(0.01);
+        for (auto& v : latencies) v = dist(rng);
+        std::vector<double> probs = {0.5, 0.9, 0.99, 0.999, 0.0, 1.0};
+        auto q = mathlib::quantiles(latencies, probs);
+        std::vector<double> sorted = latencies;
+        std::sort(sorted.begin(), sorted.end());
+        bool ok = true;
+        for (size_t i = 0; i < probs.size(); ++i) {
+            double h = probs[i] * static_cast<double>(sorted.size() - 1);
+            auto r = static_cast<size_t>(h);
+            double expect = sorted[r];
+            if (r + 1 < sorted.size()) expect += (h - static_cast<double>(r)) * (sorted[r + 1] - sorted[r]);
+            ok = ok && std::fabs(q[i] - expect) < 1e-9;
+        }
+        auto in_place = mathlib::quantiles_inplace(latencies, {0.5});
+        ok = ok && in_place[0] == mathlib::median(sorted);
+        std::cout << "quantiles p50/p90/p99/p99.9: " << q[0] << " " << q[1] << " " << q[2]
+                  << " " << q[3] << (ok ? " (matches sort)" : " (MISMATCH)") << "\n";
+        if (!ok) return 1;
+    }
+
+    // Quantile sketch: per-thread sketches merged, then round-tripped
+    // through the serialized form
+    {
+        std::vector<double> samples(200000);
+        std::mt19937_64 rng(11);
+        std::lognormal_distribution<double> dist(0.0, 1.5);
+        for (auto& v : samples) v = dist(rng);
+        mathlib::KllSketch a, b;
+        std::thread t1([&] { for (size_t i = 0; i < samples.size(); i += 2) a.update(samples[i]); });
+        std::thread t2([&] { for (size_t i = 1; i < samples.size(); i += 2) b.update(samples[i]); });
+        t1.join();
+        t2.join();
+        a.merge(b);
+        auto bytes = a.serialize();
+        auto sketch = mathlib::KllSketch::deserialize(bytes.data(), bytes.size());
+        double est = sketch.quantile(0.5);
+        std::vector<double> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        double true_rank = static_cast<double>(std::upper_bound(sorted.begin(), sorted.end(), est) -
+                                               sorted.begin()) / static_cast<double>(sorted.size());
+        // A count the levels do not add up to is rejected, not trusted.
+        bool rejected = false;
+        bytes[8] ^= 1;  // low byte of n, after the magic and k
+        try {
+            mathlib::KllSketch::deserialize(bytes.data(), bytes.size());
+        } catch (const std::invalid_argument&) {
+            rejected = true;
+        }
+        bool ok = sketch.count() == samples.size() && std::fabs(true_rank - 0.5) < 0.0165 &&
+                  sketch.min() == sorted.front() && sketch.max() == sorted.back() && rejected;
+        std::cout << "kll: n=" << sketch.count() << " retained=" << sketch.retained()
+                  << " bytes=" << bytes.size() << " median~" << est
+                  << " (exact " << mathlib::median(samples) << ", rank " << true_rank << ")"
+                  << (ok ? "" : " FAILED") << "\n";
+        if (!ok) return 1;
+    }
+
+    // Latency histogram: concurrent recording, reset-on-read snapshot
+    {
+        mathlib::LatencyHistogram hist(1000000000ull, 3);
+        std::vector<std::thread> writers;
+        for (int t = 0; t < 4; ++t) {
+            writers.emplace_back([&hist] {
+                for (std::uint64_t v = 1; v <= 100000; ++v) hist.record(v);
+            });
+        }
+        for (auto& w : writers) w.join();
+        auto snap = hist.snapshot_and_reset();
+        snap.merge(hist.snapshot());  // empty after reset: no-op
+        auto p50 = snap.value_at_quantile(0.5);
+        auto p99 = snap.value_at_quantile(0.99);
+        bool ok = snap.total_count() == 400000 && hist.snapshot().total_count() == 0 &&
+                  std::fabs(static_cast<double>(p50) - 50000.0) <= 50.0 &&
+                  std::fabs(static_cast<double>(p99) - 99000.0) <= 99.0;
+        std::cout << "histogram: n=" << snap.total_count() << " p50=" << p50 << " p99=" << p99
+                  << " max=" << snap.max() << (ok ? "" : " FAILED") << "\n";
+        if (!ok) return 1;
+    }
+
+    // Sliding window: O(1) push, checked against recomputing over a copy
+    {
+        mathlib::SlidingWindow win(50);
+        std::vector<double> history;
+        std::mt19937_64 rng(5);
+        std::normal_distribution<double> dist(100.0, 15.0);
+        bool ok = true;
+        for (int i = 0; i < 1000 && ok; ++i) {
+            double v = dist(rng);
+            win.push(v);
+            history.push_back(v);
+            if (history.size() < 2) continue;
+            std::vector<double> tail(history.end() - static_cast<std::ptrdiff_t>(win.size()), history.end());
+            ok = std::fabs(win.mean() - mathlib::mean(tail)) < 1e-9 &&
+                 std::fabs(win.standard_deviation() - mathlib::standard_deviation(tail)) < 1e-9 &&
+                 win.min() == *std::min_element(tail.begin(), tail.end()) &&
+                 win.max() == *std::max_element(tail.begin(), tail.end());
+        }
+
+        // Time-based: only samples from the last 10 ms survive
+        mathlib::SlidingWindow recent(100, std::chrono::milliseconds(10));
+        auto t0 = mathlib::SlidingWindow::clock::now();
+        for (int ms = 0; ms < 30; ++ms) recent.push(ms, t0 + std::chrono::milliseconds(ms));
+        ok = ok && recent.size() == 11 && recent.min() == 19.0 && recent.max() == 29.0;
+        std::cout << "sliding window: n=" << win.size() << " mean=" << win.mean()
+                  << " min=" << win.min() << " max=" << win.max()
+                  << " | last 10ms n=" << recent.size() << (ok ? "" : " FAILED") << "\n";
+        if (!ok) return 1;
+    }
+
+    // Typed, non-throwing statistics directly on float / int16 / uint32 data
+    {
+        std::vector<float> f(data.begin(), data.end());
+        std::array<std::int16_t, 8> adc = {2, 4, 4, 4, 5, 5, 7, 9};
+        std::vector<std::uint32_t> counters = {4000000000u, 4000000002u};
+        auto fm = mathlib::try_mean(f);
+        auto as = mathlib::try_standard_deviation(adc);
+        auto cm = mathlib::try_mean(counters);
+        auto amin = mathlib::try_min(adc);
+        auto empty = mathlib::try_mean(std::vector<int>{});
+        auto one = mathlib::try_standard_deviation(adc.data(), 1);
+        auto av = mathlib::try_variance(adc.data(), adc.size());
+        bool ok = fm && fm.value == 5.0 && as && av && std::fabs(av.value - as.value * as.value) < 1e-12 &&
+                  std::fabs(as.value - mathlib::standard_deviation(data)) < 1e-12 &&
+                  cm.value == 4000000001.0 && amin.value == 2 &&
+                  empty.error == mathlib::StatsError::EmptyInput &&
+                  one.error == mathlib::StatsError::TooFewValues;
+        std::cout << "typed: float mean=" << fm.value << " int16 stddev=" << as.value
+                  << " uint32 mean=" << static_cast<std::uint64_t>(cm.value)
+                  << " empty -> " << mathlib::stats_error_name(empty.error)
+                  << (ok ? "" : " FAILED") << "\n";
+        if (!ok) return 1;
+    }
+
+    // Parallel reductions on a private 4-worker pool, forced past the
+    // serial threshold, against the serial functions
+    {
+        std::vector<double> big(300001);
+        std::mt19937_64 rng(9);
+        std::normal_distribution<double> dist(-3.0, 50.0);
+        for (auto& v : big) v = dist(rng);
+        big[17] = big[18];  // duplicates must not confuse the selection
+        mathlib::WorkerPool pool(4);
+        mathlib::ParallelOptions opts;
+        opts.pool = &pool;
+        opts.serial_threshold = 0;
+        opts.chunk_elements = 4096;
+        double pm = mathlib::parallel_mean(big, opts);
+        double ps = mathlib::parallel_standard_deviation(big, opts);
+        double pmed = mathlib::parallel_median(big, opts);
+        bool ok = std::fabs(pm - mathlib::mean(big)) < 1e-9 &&
+                  std::fabs(ps - mathlib::standard_deviation(big)) < 1e-9 &&
+                  pmed == mathlib::median(big);
+        big.pop_back();  // even length: average of the two middle ranks
+        ok = ok && mathlib::parallel_median(big, opts) == mathlib::median(big);
+        std::cout << "parallel (" << pool.size() << " workers, " << mathlib::default_worker_count()
+                  << " cpus): mean=" << pm << " stddev=" << ps << " median=" << pmed
+                  << (ok ? "" : " FAILED") << "\n";
+        if (!ok) return 1;
+    }
+
+    // Streaming statistics: one pass, no sample storage
+    mathlib::RunningStats rs;
+    for (double v : data) rs.push(v);
+    std::cout << "running: n=" << rs.count() << " mean=" << rs.mean()
+              << " stddev=" << rs.standard_deviation()
+              << " min=" << rs.min() << " max=" << rs.max() << "\n";
+
+    // Per-thread partial accumulators merged at the end
+    mathlib::RunningStats lo, hi;
+    std::thread t1([&] { for (size_t i = 0; i < data.size() / 2; ++i) lo.push(data[i]); });
+    std::thread t2([&] { for (size_t i = data.size() / 2; i < data.size(); ++i) hi.push(data[i]); });
+    t1.join();
+    t2.join();
+    lo.merge(hi);
+    bool match = std::fabs(lo.mean() - mathlib::mean(data)) < 1e-12 &&
+                 std::fabs(lo.standard_deviation() - mathlib::standard_deviation(data)) < 1e-12;
+    std::cout << "merged: n=" << lo.count() << " mean=" << lo.mean()
+              << " stddev=" << lo.standard_deviation()
+              << (match ? " (matches two-pass)" : " (MISMATCH)") << "\n";
+    if (!match) return 1;
+
+    // SIMD kernels: every ISA this CPU supports against the scalar reference
+    std::cout << "simd dispatch: " << mathlib::simd::isa_name(mathlib::simd::kernels().isa) << "\n";
+    for (auto isa : {mathlib::simd::Isa::AVX2, mathlib::simd::Isa::AVX512, mathlib::simd::Isa::NEON}) {
+        const auto* k = mathlib::simd::kernels_for(isa);
+        if (!k) continue;
+        bool ok = check_kernels(*k);
+        std::cout << "simd " << mathlib::simd::isa_name(isa) << " vs scalar: "
+                  << (ok ? "ok" : "FAILED") << "\n";
+        if (!ok) return 1;
+    }
+
+    // Memory-mapped column file: zero-copy views straight into statistics
+    {
+        std::vector<double> temp(10000);
+        std::vector<float> pressure(temp.size());
+        for (size_t i = 0; i < temp.size(); ++i) {
+            temp[i] = 20.0 + static_cast<double>(i % 100) * 0.1;
+            pressure[i] = 1000.0f + static_cast<float>(i % 7);
+        }
+        const char* tmp = std::getenv("TMPDIR");
+        const std::string path =
+            std::string(tmp ? tmp : "/tmp") + "/static_lib_test_" + std::to_string(getpid()) + ".col";
+        mathlib::write_column_file(path, temp.size(),
+                                   {{"temp", mathlib::ColumnType::Float64, temp.data()},
+                                    {"pressure", mathlib::ColumnType::Float32, pressure.data()}});
+        bool ok;
+        {
+            mathlib::ColumnFile file(path);
+            auto t = file.column<double>("temp");
+            auto p = file.column<float>("pressure");
+            mathlib::RunningStats streamed;
+            mathlib::for_each_chunk(file.file(), t, 1024,
+                                    [&](mathlib::ArrayView<double> c) { streamed.push(c.data(), c.size()); });
+            ok = file.rows() == temp.size() &&
+                 std::fabs(mathlib::try_mean(t).value - mathlib::mean(temp)) < 1e-9 &&
+                 std::fabs(streamed.standard_deviation() - mathlib::standard_deviation(temp)) < 1e-9 &&
+                 mathlib::try_max(p).value == 1006.0f;
+            try {
+                file.column<float>("temp");
+                ok = false;
+            } catch (const std::invalid_argument&) {
+            }
+            std::cout << "column file: rows=" << file.rows() << " temp mean=" << mathlib::try_mean(t).value
+                      << " streamed stddev=" << streamed.standard_deviation()
+                      << " pressure max=" << mathlib::try_max(p).value << (ok ? "" : " FAILED") << "\n";
+        }
+        std::remove(path.c_str());
+        if (!ok) return 1;
+    }
+
     // Template function from header
     std::cout << "clamp(15, 0, 10) = " << mathlib::clamp(15, 0, 10) << "\n";
     std::cout << "clamp(-5.0, 0.0, 1.0) = " << mathlib::clamp(-5.0, 0.0, 1.0) << "\n";
@@ -0,0 +1,194 @@
+// Static library: statistics over any contiguous range of arithmetic type
+#ifndef STATS_VIEW_H
+#define STATS_VIEW_H
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include "simd_kernels.h"
+
+namespace mathlib {
+
+// Non-owning view of contiguous elements (C++17 has no std::span).
+template <typename T>
+class ArrayView {
+public:
+    constexpr ArrayView() noexcept = default;
+    constexpr ArrayView(const T* data, std::size_t size) noexcept : data_(data), size_(size) {}
+    template <typename Alloc>
+    ArrayView(const std::vector<T, Alloc>& v) noexcept : data_(v.data()), size_(v.size()) {}
+    template <std::size_t N>
+    constexpr ArrayView(const std::array<T, N>& a) noexcept : data_(a.data()), size_(N) {}
+    template <std::size_t N>
+    constexpr ArrayView(const T (&a)[N]) noexcept : data_(a), size_(N) {}
+
+    constexpr const T* data() const noexcept { return data_; }
+    constexpr std::size_t size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr const T* begin() const noexcept { return data_; }
+    constexpr const T* end() const noexcept { return data_ + size_; }
+    constexpr const T& operator[](std::size_t i) const noexcept { return data_[i]; }
+
+private:
+    const T* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+enum class StatsError { None, EmptyInput, TooFewValues };
+
+inline const char* stats_error_name(StatsError e) noexcept {
+    switch (e) {
+        case StatsError::None:         return "none";
+        case StatsError::EmptyInput:   return "empty data";
+        case StatsError::TooFewValues: return "need at least 2 values";
+    }
+    return "unknown";
+}
+
+// Value-or-error return for the non-throwing statistics below.
+template <typename T>
+struct StatsResult {
+    T value{};
+    StatsError error = StatsError::None;
+
+    constexpr bool ok() const noexcept { return error == StatsError::None; }
+    constexpr explicit operator bool() const noexcept { return ok(); }
+    static constexpr StatsResult failure(StatsError e) noexcept { return {T{}, e}; }
+};
+
+// Accumulator chosen per element type: exact integer sums for narrow
+// integers, double for everything else (float data is summed in double).
+template <typename T>
+using accumulator_t = std::conditional_t<
+    std::is_integral_v<T> && (sizeof(T) <= 4),
+    std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>,
+    double>;
+
+namespace detail {
+
+template <typename T>
+constexpr void check_arithmetic() {
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+                  "statistics need an arithmetic element type");
+}
+
+}  // namespace detail
+
+// Non-throwing counterparts of mean() / standard_deviation() for any
+// arithmetic element type, taking the data in place (no conversion copy).
+// Integer sums of 8/16/32-bit data are exact for up to 2^31 elements.
+template <typename T>
+StatsResult<double> try_mean(ArrayView<T> data) noexcept {
+    detail::check_arithmetic<T>();
+    if (data.empty()) return StatsResult<double>::failure(StatsError::EmptyInput);
+    if constexpr (std::is_same_v<T, double>) {
+        return {simd::sum(data.data(), data.size()) / static_cast<double>(data.size())};
+    } else {
+        accumulator_t<T> sum = 0;
+        for (T v : data) sum += static_cast<accumulator_t<T>>(v);
+        return {static_cast<double>(sum) / static_cast<double>(data.size())};
+    }
+}
+
+template <typename T>
+StatsResult<double> try_variance(ArrayView<T> data) noexcept {
+    detail::check_arithmetic<T>();
+    if (data.size() < 2) return StatsResult<double>::failure(StatsError::TooFewValues);
+    const double n = static_cast<double>(data.size());
+    if constexpr (std::is_integral_v<T> && sizeof(T) <= 2) {
+        // Squares of 16-bit values fit easily in 64 bits, so one pass of
+        // exact integer sums replaces the two-pass floating-point path.
+        using Acc = std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>;
+        Acc sum = 0, sum_sq = 0;
+        for (T v : data) {
+            Acc x = static_cast<Acc>(v);
+            sum += x;
+            sum_sq += x * x;
+        }
+        // n * sum_sq - sum^2 can exceed 64 bits; finish in long double.
+        long double s = static_cast<long double>(sum);
+        long double num = static_cast<long double>(n) * static_cast<long double>(sum_sq) - s * s;
+        return {static_cast<double>(num / (static_cast<long double>(n) * static_cast<long double>(n - 1)))};
+    } else if constexpr (std::is_same_v<T, double>) {
+        double m = try_mean(data).value;
+        return {simd::sum_sq_dev(data.data(), data.size(), m) / (n - 1.0)};
+    } else {
+        double m = try_mean(data).value;
+        double sq_sum = 0.0;
+        for (T v : data) {
+            double d = static_cast<double>(v) - m;
+            sq_sum += d * d;
+        }
+        return {sq_sum / (n - 1.0)};
+    }
+}
+
+template <typename T>
+StatsResult<double> try_standard_deviation(ArrayView<T> data) noexcept {
+    auto var = try_variance(data);
+    if (!var) return var;
+    return {std::sqrt(var.value)};
+}
+
+template <typename T>
+StatsResult<T> try_min(ArrayView<T> data) noexcept {
+    detail::check_arithmetic<T>();
+    if (data.empty()) return StatsResult<T>::failure(StatsError::EmptyInput);
+    T lo = data[0];
+    for (T v : data) lo = v < lo ? v : lo;
+    return {lo};
+}
+
+template <typename T>
+StatsResult<T> try_max(ArrayView<T> data) noexcept {
+    detail::check_arithmetic<T>();
+    if (data.empty()) return StatsResult<T>::failure(StatsError::EmptyInput);
+    T hi = data[0];
+    for (T v : data) hi = v > hi ? v : hi;
+    return {hi};
+}
+
+// Deduction helpers so callers can pass a vector, std::array or pointer +
+// length without naming ArrayView.
+template <typename C>
+auto try_mean(const C& c) noexcept -> decltype(try_mean(ArrayView<typename C::value_type>(c))) {
+    return try_mean(ArrayView<typename C::value_type>(c));
+}
+template <typename C>
+auto try_variance(const C& c) noexcept -> decltype(try_variance(ArrayView<typename C::value_type>(c))) {
+    return try_variance(ArrayView<typename C::value_type>(c));
+}
+template <typename C>
+auto try_standard_deviation(const C& c) noexcept
+    -> decltype(try_standard_deviation(ArrayView<typename C::value_type>(c))) {
+    return try_standard_deviation(ArrayView<typename C::value_type>(c));
+}
+template <typename C>
+auto try_min(const C& c) noexcept -> decltype(try_min(ArrayView<typename C::value_type>(c))) {
+    return try_min(ArrayView<typename C::value_type>(c));
+}
+template <typename C>
+auto try_max(const C& c) noexcept -> decltype(try_max(ArrayView<typename C::value_type>(c))) {
+    return try_max(ArrayView<typename C::value_type>(c));
+}
+
+template <typename T>
+StatsResult<double> try_mean(const T* data, std::size_t n) noexcept { return try_mean(ArrayView<T>(data, n)); }
+template <typename T>
+StatsResult<double> try_variance(const T* data, std::size_t n) noexcept { return try_variance(ArrayView<T>(data, n)); }
+template <typename T>
+StatsResult<double> try_standard_deviation(const T* data, std::size_t n) noexcept {
+    return try_standard_deviation(ArrayView<T>(data, n));
+}
+template <typename T>
+StatsResult<T> try_min(const T* data, std::size_t n) noexcept { return try_min(ArrayView<T>(data, n)); }
+template <typename T>
+StatsResult<T> try_max(const T* data, std::size_t n) noexcept { return try_max(ArrayView<T>(data, n)); }
+
+}  // namespace mathlib
+
+#endif  // STATS_VIEW_H